@@ -21,6 +21,10 @@ public class GDF180 : ModuleRules
 			"StaticMeshDescription",
 			"MeshConversion",
 			"ModelingComponents",
+			"RenderCore",
+			"GeometryCore",
+			"GeometryFramework",
+			"DynamicMesh",
 		]);
 
 		// Uncomment if you are using Slate UI
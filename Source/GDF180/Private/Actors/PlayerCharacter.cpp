@@ -56,6 +56,30 @@ void APlayerCharacter::Tick(float DeltaTime)
 	Super::Tick(DeltaTime);
 }
 
+FVector APlayerCharacter::GetViewDirection() const
+{
+	if (Controller == nullptr)
+	{
+		return GetActorForwardVector();
+	}
+	
+	return Controller->GetControlRotation().Vector();
+}
+
+float APlayerCharacter::GetMaxMoveSpeed() const
+{
+	const auto* CharacterMovementComponent { GetCharacterMovement() };
+	
+	if (CharacterMovementComponent == nullptr)
+	{
+		return 0.0f;
+	}
+	
+	return CharacterMovementComponent->IsFlying() 
+		? CharacterMovementComponent->MaxFlySpeed 
+		: CharacterMovementComponent->MaxWalkSpeed;
+}
+
 void APlayerCharacter::Move(const FInputActionValue& Value)
 {
 	if (Controller == nullptr)
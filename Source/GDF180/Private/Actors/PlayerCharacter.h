@@ -19,6 +19,9 @@ public:
 	APlayerCharacter();
 
 	virtual void Tick(float DeltaTime) override;
+	
+	FVector GetViewDirection() const;
+	float GetMaxMoveSpeed() const;
 
 protected:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
@@ -24,6 +24,24 @@ void USectorComponent::Initialize(const FIntPoint& InSectorCoordinates, const FV
 	WorldLocation = InWorldLocation;
 }
 
+void USectorComponent::SetupDynamicMeshComponents()
+{
+	if (GroundDynamicMeshComponent)
+	{
+		return;
+	}
+	
+	GroundDynamicMeshComponent = NewObject<UDynamicMeshComponent>(this, TEXT("GroundDynamicMesh"));
+	GroundDynamicMeshComponent->SetMobility(EComponentMobility::Movable);
+	GroundDynamicMeshComponent->AttachToComponent(this, FAttachmentTransformRules::KeepRelativeTransform);
+	GroundDynamicMeshComponent->RegisterComponent();
+	
+	WaterDynamicMeshComponent = NewObject<UDynamicMeshComponent>(this, TEXT("WaterDynamicMesh"));
+	WaterDynamicMeshComponent->SetMobility(EComponentMobility::Movable);
+	WaterDynamicMeshComponent->AttachToComponent(this, FAttachmentTransformRules::KeepRelativeTransform);
+	WaterDynamicMeshComponent->RegisterComponent();
+}
+
 void USectorComponent::OnRegister()
 {
 	Super::OnRegister();
@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "Components/SceneComponent.h"
 #include "Components/StaticMeshComponent.h"
+#include "Components/DynamicMeshComponent.h"
 #include "SectorComponent.generated.h"
 
 
@@ -23,7 +24,14 @@ public:
 	UPROPERTY(VisibleDefaultsOnly)
 	TObjectPtr<UStaticMeshComponent> WaterStaticMeshComponent;
 	
+	UPROPERTY(VisibleInstanceOnly)
+	TObjectPtr<UDynamicMeshComponent> GroundDynamicMeshComponent;
+
+	UPROPERTY(VisibleInstanceOnly)
+	TObjectPtr<UDynamicMeshComponent> WaterDynamicMeshComponent;
+	
 	void Initialize(const FIntPoint& InSectorCoordinates, const FVector3f& InWorldLocation);
+	void SetupDynamicMeshComponents();
 	
 protected:
 	virtual void OnRegister() override;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ScatterRule.h"
 #include "BiomeDefinition.generated.h"
 
 
@@ -13,4 +14,7 @@ struct FBiomeDefinition
 	
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	FLinearColor DebugColor { FLinearColor::Black };
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	TArray<FScatterRule> ScatterRuleArray;
 };
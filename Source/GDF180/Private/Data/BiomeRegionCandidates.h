@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../../ThirdParty/FastNoiseLite/FastNoiseLite.h"
+
+
+struct FBiomeRegionCandidates
+{
+	TArray<FastNoiseLite::CellularCandidate, TInlineAllocator<16>> CandidateArray;
+	
+	// Biome of each candidate's region, resolved once so cells only look up the candidate they fall in
+	TArray<uint8, TInlineAllocator<16>> CandidateBiomeIndexArray;
+	
+	bool bSingleRegion { false };
+	uint8 SingleRegionBiomeIndex { 0 };
+
+	void Clear()
+	{
+		CandidateArray.Reset();
+		CandidateBiomeIndexArray.Reset();
+		
+		bSingleRegion = false;
+		SingleRegionBiomeIndex = 0;
+	}
+};
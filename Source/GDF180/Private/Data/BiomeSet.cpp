@@ -71,8 +71,13 @@ float UBiomeSet::GetFrequency() const
 
 const FRingDefinition& UBiomeSet::GetRingDefinition(const float Radius) const
 {
-	const FRingDefinition* RingDefinition { 
-		RingDefinitionArray.FindByPredicate(
+	return RingDefinitionArray[GetRingIndex(Radius)];
+}
+
+int32 UBiomeSet::GetRingIndex(const float Radius) const
+{
+	const int32 RingIndex { 
+		RingDefinitionArray.IndexOfByPredicate(
 			[&](const FRingDefinition& Candidate)
 			{
 				return Radius >= Candidate.InnerRadius &&
@@ -81,11 +86,10 @@ const FRingDefinition& UBiomeSet::GetRingDefinition(const float Radius) const
 		) 
 	};
 
-	if (RingDefinition)
+	if (RingIndex != INDEX_NONE)
 	{
-		return *RingDefinition;
+		return RingIndex;
 	}
 	
-	return RingDefinitionArray.Last();
+	return RingDefinitionArray.Num() - 1;
 }
-
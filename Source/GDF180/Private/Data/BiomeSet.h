@@ -29,4 +29,5 @@ public:
 	float GetFrequency() const;
 	
 	const FRingDefinition& GetRingDefinition(const float Radius) const;
+	int32 GetRingIndex(const float Radius) const;
 };
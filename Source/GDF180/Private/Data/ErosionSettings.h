@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ErosionSettings.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FErosionSettings
+{
+	GENERATED_BODY()
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool bEnabled { false };
+	
+	// Every iteration widens the halo sampled around a generated region by three cells
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 IterationNum { 16 };
+	
+	// Water added to every vertex per iteration, in centimeters
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float RainAmount { 2.0f };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float SedimentCapacity { 4.0f };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float ErosionRate { 0.3f };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float DepositionRate { 0.3f };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float EvaporationRate { 0.05f };
+	
+	// Most height one vertex can lose in a single iteration, in centimeters
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float MaxErosionDepth { 20.0f };
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "HorizonSettings.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FHorizonSettings
+{
+	GENERATED_BODY()
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool bEnabled { false };
+	
+	// Terrain cells per horizon cell; noise layers with periods under two horizon cells are left out
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 CellSizeInCells { 16 };
+	
+	// Drop below the sampled heights so streamed sectors cover the horizon where the two overlap
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float SinkDepth { 200.0f };
+};
@@ -6,11 +6,19 @@
 struct FMeshRenderData
 {
 	TArray<FVector3f> VertexArray;
-	TArray<int32> IndexArray;
+	TArray<uint32> IndexArray;
 	TArray<FVector2f> UVArray;
 	TArray<uint8> BiomeIndexArray;
 	TArray<FVector4f> VertexColorArray;
 
+	void Reserve(const int32 VertexNum, const int32 IndexNum)
+	{
+		VertexArray.Reserve(VertexNum);
+		IndexArray.Reserve(IndexNum);
+		UVArray.Reserve(VertexNum);
+		VertexColorArray.Reserve(VertexNum);
+	}
+
 	void Clear()
 	{
 		VertexArray.Reset();
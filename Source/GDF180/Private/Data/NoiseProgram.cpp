@@ -0,0 +1,68 @@
+#include "NoiseProgram.h"
+
+
+int32 FNoiseProgram::FindGroupIndex(const FString& Name) const
+{
+	return GroupArray.IndexOfByPredicate(
+		[&](const FNoiseProgramGroup& Candidate)
+		{
+			return Candidate.Name.Equals(Name, ESearchCase::IgnoreCase);
+		}
+	);
+}
+
+float FNoiseProgram::GetNoiseCallsPerSample() const
+{
+	float NoiseCallsPerSample { 0.0f };
+	
+	// A coarse layer is evaluated once per lattice point, which covers LatticeStep^2 samples
+	for (const FNoiseProgramLayer& ProgramLayer : LayerArray)
+	{
+		NoiseCallsPerSample += 1.0f / (ProgramLayer.LatticeStep * ProgramLayer.LatticeStep);
+	}
+	
+	return NoiseCallsPerSample;
+}
+
+int32 FNoiseProgram::GetMaxLatticeStep() const
+{
+	int32 MaxLatticeStep { 1 };
+	
+	for (const FNoiseProgramLayer& ProgramLayer : LayerArray)
+	{
+		MaxLatticeStep = FMath::Max(MaxLatticeStep, ProgramLayer.LatticeStep);
+	}
+	
+	return MaxLatticeStep;
+}
+
+float FNoiseProgram::SampleLayer(const int32 LayerIndex, const FVector2f WorldPosition) const
+{
+	constexpr float XScale { 1.01f };
+	constexpr float XOffset { 17.123f };
+	
+	constexpr float YScale { 0.99f };
+	constexpr float YOffset { 43.512f };
+	
+	return LayerArray[LayerIndex].Noise.GetNoise(
+		WorldPosition.X * XScale + XOffset, 
+		WorldPosition.Y * YScale + YOffset
+	);
+}
+
+float FNoiseProgram::SampleGroup(const int32 GroupIndex, const FVector2f WorldPosition) const
+{
+	if (!GroupArray.IsValidIndex(GroupIndex))
+	{
+		return 0.0f;
+	}
+	
+	float NoiseValue { 0.0f };
+
+	for (const auto& [LayerIndex, Scale] : GroupArray[GroupIndex].TermArray)
+	{
+		NoiseValue += Scale * SampleLayer(LayerIndex, WorldPosition);
+	}
+
+	return NoiseValue;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../../ThirdParty/FastNoiseLite/FastNoiseLite.h"
+
+
+struct FNoiseProgramLayer
+{
+	float Period { 0.0f };
+	float MaxAmplitude { 0.0f };
+	int32 LatticeStep { 1 };
+	
+	FastNoiseLite Noise;
+};
+
+struct FNoiseProgramTerm
+{
+	int32 LayerIndex { INDEX_NONE };
+	float Scale { 0.0f };
+};
+
+struct FNoiseProgramGroup
+{
+	FString Name;
+	
+	TArray<FNoiseProgramTerm> TermArray;
+};
+
+struct FNoiseProgram
+{
+	TArray<FNoiseProgramLayer> LayerArray;
+	TArray<FNoiseProgramGroup> GroupArray;
+
+	int32 FindGroupIndex(const FString& Name) const;
+	float GetNoiseCallsPerSample() const;
+	int32 GetMaxLatticeStep() const;
+	
+	float SampleLayer(const int32 LayerIndex, const FVector2f WorldPosition) const;
+	float SampleGroup(const int32 GroupIndex, const FVector2f WorldPosition) const;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+struct FRiverSegment
+{
+	FVector2f Start;
+	FVector2f End;
+	
+	float StartBedHeight;
+	float EndBedHeight;
+	float HalfWidth;
+	
+	FBox2f Bounds;
+};
+
+// River segments with a compressed per-sector index, built once and read-only while sectors generate
+struct FRiverNetwork
+{
+	int32 SectorSizeInCells { 1 };
+	float CellSizeInCentimeters { 1.0f };
+	
+	// Sector-sized tiles per axis, one more than the world size so the far world edge vertices have a tile
+	int32 TileNum { 0 };
+	
+	float WaterDepth { 0.0f };
+	float BankFalloff { 0.0f };
+	
+	TArray<FRiverSegment> SegmentArray;
+	
+	// The segments of tile Y * TileNum + X are SegmentIndexArray[TileOffsetArray[Index]] up to TileOffsetArray[Index + 1]
+	TArray<int32> TileOffsetArray;
+	TArray<int32> SegmentIndexArray;
+
+	TConstArrayView<int32> GetTileSegments(const FIntPoint TileCoordinates) const
+	{
+		if (
+			TileOffsetArray.IsEmpty() ||
+			TileCoordinates.X < 0 || TileCoordinates.Y < 0 || 
+			TileCoordinates.X >= TileNum || TileCoordinates.Y >= TileNum
+		) {
+			return {};
+		}
+		
+		const int32 TileIndex { TileCoordinates.Y * TileNum + TileCoordinates.X };
+		
+		return TConstArrayView<int32> { 
+			SegmentIndexArray.GetData() + TileOffsetArray[TileIndex], 
+			TileOffsetArray[TileIndex + 1] - TileOffsetArray[TileIndex] 
+		};
+	}
+	
+	// Carves channels into the terrain heights and raises the water heights to the river surface, for a row-major 
+	// region covering VertexNum vertices from OriginInVertices
+	void ApplyToRegion(
+		const FIntPoint OriginInVertices, 
+		const FIntPoint VertexNum, 
+		TArray<float>& TerrainHeightArray, 
+		TArray<float>& WaterHeightArray
+	) const {
+		if (SegmentIndexArray.IsEmpty())
+		{
+			return;
+		}
+		
+		const FIntPoint RegionMax { OriginInVertices + VertexNum };
+		
+		const FIntPoint MinTile { FIntPoint::DivideAndRoundDown(OriginInVertices, SectorSizeInCells) };
+		const FIntPoint MaxTile { FIntPoint::DivideAndRoundDown(RegionMax - FIntPoint { 1 }, SectorSizeInCells) };
+		
+		for (int32 TileY { MinTile.Y }; TileY <= MaxTile.Y; ++TileY)
+		{
+			for (int32 TileX { MinTile.X }; TileX <= MaxTile.X; ++TileX)
+			{
+				const FIntPoint TileOrigin { FIntPoint { TileX, TileY } * SectorSizeInCells };
+				
+				const FIntPoint TileMin { TileOrigin.ComponentMax(OriginInVertices) };
+				const FIntPoint TileMax { (TileOrigin + FIntPoint { SectorSizeInCells }).ComponentMin(RegionMax) };
+				
+				// Each vertex belongs to one tile, so it always sees the same segments in the same order
+				for (const int32 SegmentIndex : GetTileSegments({ TileX, TileY }))
+				{
+					const FRiverSegment& Segment { SegmentArray[SegmentIndex] };
+					
+					const FIntPoint Min { 
+						TileMin.ComponentMax(
+							FIntPoint { 
+								FMath::CeilToInt(Segment.Bounds.Min.X / CellSizeInCentimeters), 
+								FMath::CeilToInt(Segment.Bounds.Min.Y / CellSizeInCentimeters) 
+							}
+						) 
+					};
+					
+					const FIntPoint Max { 
+						TileMax.ComponentMin(
+							FIntPoint { 
+								FMath::FloorToInt(Segment.Bounds.Max.X / CellSizeInCentimeters) + 1, 
+								FMath::FloorToInt(Segment.Bounds.Max.Y / CellSizeInCentimeters) + 1 
+							}
+						) 
+					};
+					
+					const FVector2f Direction { Segment.End - Segment.Start };
+					const float InverseLengthSquared { 1.0f / FMath::Max(Direction.SizeSquared(), UE_SMALL_NUMBER) };
+					
+					for (int32 Y { Min.Y }; Y < Max.Y; ++Y)
+					{
+						for (int32 X { Min.X }; X < Max.X; ++X)
+						{
+							const FVector2f Offset { FVector2f { X * CellSizeInCentimeters, Y * CellSizeInCentimeters } - Segment.Start };
+							
+							const float Alpha { FMath::Clamp(FVector2f::DotProduct(Offset, Direction) * InverseLengthSquared, 0.0f, 1.0f) };
+							const float Distance { (Offset - Alpha * Direction).Size() };
+							
+							if (Distance >= Segment.HalfWidth + BankFalloff)
+							{
+								continue;
+							}
+							
+							const float BedHeight { FMath::Lerp(Segment.StartBedHeight, Segment.EndBedHeight, Alpha) };
+							const float SurfaceHeight { BedHeight + WaterDepth };
+							
+							const int32 Index { (Y - OriginInVertices.Y) * VertexNum.X + X - OriginInVertices.X };
+							
+							// Channels only ever lower the terrain, so overlapping segments combine in any order
+							float& TerrainHeight { TerrainHeightArray[Index] };
+							
+							const float OriginalHeight { TerrainHeight };
+							
+							TerrainHeight = FMath::Min(
+								TerrainHeight, 
+								FMath::Lerp(BedHeight, TerrainHeight, FMath::SmoothStep(Segment.HalfWidth, Segment.HalfWidth + BankFalloff, Distance))
+							);
+							
+							// Where the coarse bed runs over a pit the fine terrain lacks, the channel stays dry instead of floating
+							if (OriginalHeight >= BedHeight && TerrainHeight < SurfaceHeight)
+							{
+								WaterHeightArray[Index] = FMath::Max(WaterHeightArray[Index], SurfaceHeight);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "RiverSettings.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FRiverSettings
+{
+	GENERATED_BODY()
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool bEnabled { false };
+	
+	// Terrain cells between nodes of the coarse world grid that flow is routed over
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 FlowCellSizeInCells { 16 };
+	
+	// Fraction of all grid nodes that must drain through a node before a river channel starts there
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float MinAccumulationFraction { 0.02f };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float MinWidth { 300.0f };
+	
+	// Extra width per unit of square root accumulation above the threshold
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float WidthScale { 40.0f };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float ChannelDepth { 300.0f };
+	
+	// Height of the river surface above the channel bed
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float WaterDepth { 200.0f };
+	
+	// Distance beyond the channel over which its banks blend back into the terrain
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float BankFalloff { 800.0f };
+};
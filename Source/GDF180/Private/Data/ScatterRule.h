@@ -0,0 +1,44 @@
+#pragma once
+
+#include "ScatterRule.generated.h"
+
+
+class UStaticMesh;
+
+USTRUCT(BlueprintType)
+struct FScatterRule
+{
+	GENERATED_BODY()
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	TObjectPtr<UStaticMesh> Mesh;
+	
+	// Poisson-disk radius between instances of this rule
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	float MinSpacing { 500.0f };
+	
+	// Fraction of disk candidates kept, thinning the placements below the packing that MinSpacing allows
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	float Density { 1.0f };
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	float MinScale { 0.8f };
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	float MaxScale { 1.2f };
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	float MaxSlopeDegrees { 30.0f };
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	bool bAlignToSurface { false };
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	bool bAllowUnderwater { false };
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	bool bGenerateCollision { false };
+	
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	float CullDistance { 20000.0f };
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SectorRenderData.h"
+#include <atomic>
+
+
+struct FSectorGenerationRequest
+{
+	FIntPoint SectorCoordinates;
+	
+	int32 Priority { 0 };
+	bool bRunning { false };
+	
+	std::atomic<bool> bCancelled { false };
+	
+	// Set by the worker once the render data is built, false when sampling failed
+	bool bSucceeded { false };
+	
+	FSectorRenderData SectorRenderData;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SectorGenerationRequest.h"
+#include "SectorMeshes.h"
+#include "SectorRenderData.h"
+#include "SectorGrid.generated.h"
+
+
+class USectorComponent;
+class UHierarchicalInstancedStaticMeshComponent;
+
+USTRUCT()
+struct FSectorSlot
+{
+	GENERATED_BODY()
+	
+	FIntPoint SectorCoordinates { FIntPoint::ZeroValue };
+	
+	bool bClaimed { false };
+	bool bHasRenderData { false };
+	bool bBuildingMeshes { false };
+	
+	// The committed component still shows meshes from render data that has since been regenerated
+	bool bMeshesOutdated { false };
+	
+	// Tags each mesh build, so results of a build the slot has since abandoned are discarded
+	uint32 MeshBuildId { 0 };
+	
+	UPROPERTY()
+	TObjectPtr<USectorComponent> SectorComponent;
+	
+	UPROPERTY()
+	FSectorMeshes SectorMeshes;
+	
+	// One instanced component per scatter rule, kept with the slot and reused by each sector that claims it
+	UPROPERTY()
+	TArray<TObjectPtr<UHierarchicalInstancedStaticMeshComponent>> ScatterComponentArray;
+	
+	FSectorRenderData SectorRenderData;
+	
+	TSharedPtr<FSectorGenerationRequest> Request;
+};
+
+USTRUCT()
+struct FSectorGrid
+{
+	GENERATED_BODY()
+	
+	int32 WindowSize { 1 };
+	
+	UPROPERTY()
+	TArray<FSectorSlot> SlotArray;
+
+	void Initialize(const int32 InWindowSize)
+	{
+		WindowSize = InWindowSize;
+		
+		SlotArray.Reset();
+		SlotArray.SetNum(WindowSize * WindowSize);
+	}
+	
+	int32 GetSlotIndex(const FIntPoint& SectorCoordinates) const
+	{
+		const int32 X { (SectorCoordinates.X % WindowSize + WindowSize) % WindowSize };
+		const int32 Y { (SectorCoordinates.Y % WindowSize + WindowSize) % WindowSize };
+		
+		return Y * WindowSize + X;
+	}
+
+	// Slot that a sector maps to, which may still be claimed by another sector
+	FSectorSlot& GetSlot(const FIntPoint& SectorCoordinates)
+	{
+		return SlotArray[GetSlotIndex(SectorCoordinates)];
+	}
+
+	FSectorSlot* Find(const FIntPoint& SectorCoordinates)
+	{
+		FSectorSlot& Slot { GetSlot(SectorCoordinates) };
+		
+		return Slot.bClaimed && Slot.SectorCoordinates == SectorCoordinates ? &Slot : nullptr;
+	}
+};
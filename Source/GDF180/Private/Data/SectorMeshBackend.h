@@ -0,0 +1,11 @@
+#pragma once
+
+#include "SectorMeshBackend.generated.h"
+
+
+UENUM(BlueprintType)
+enum class ESectorMeshBackend : uint8
+{
+	StaticMesh,
+	DynamicMesh
+};
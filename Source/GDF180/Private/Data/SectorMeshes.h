@@ -1,8 +1,12 @@
 #pragma once
 
+#include "CoreMinimal.h"
 #include "SectorMeshes.generated.h"
 
 
+class UStaticMesh;
+
+
 USTRUCT()
 struct FSectorMeshes
 {
@@ -2,6 +2,8 @@
 
 #include "CoreMinimal.h"
 #include "MeshRenderData.h"
+#include "SectorScatterData.h"
+#include "SectorVoxelData.h"
 
 
 struct FSectorRenderData
@@ -10,10 +12,27 @@ struct FSectorRenderData
 	
 	FMeshRenderData GroundMeshRenderData;
 	FMeshRenderData WaterMeshRenderData;
+	
+	FSectorScatterData ScatterData;
+	FSectorVoxelData VoxelData;
+
+	void Reserve(const int32 CellNum)
+	{
+		GroundMeshRenderData.Reserve(4 * CellNum, 6 * CellNum);
+		WaterMeshRenderData.Reserve(4 * CellNum, 6 * CellNum);
+	}
 
 	void Clear()
 	{
 		GroundMeshRenderData.Clear();
 		WaterMeshRenderData.Clear();
+		ScatterData.Clear();
+		VoxelData.Clear();
+	}
+	
+	// The height field mesh stays the source for brush heights, volumetric sectors render the contoured mesh instead
+	const FMeshRenderData& GetGroundMeshRenderData() const
+	{
+		return VoxelData.bVolumetric ? VoxelData.MeshRenderData : GroundMeshRenderData;
 	}
 };
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+struct FSectorScatterData
+{
+	// Instance transforms relative to the sector, one array per scatter rule in biome set order
+	TArray<TArray<FTransform>> RuleTransformArrays;
+
+	void Reset(const int32 RuleNum)
+	{
+		RuleTransformArrays.SetNum(RuleNum);
+		
+		Clear();
+	}
+	
+	void Clear()
+	{
+		for (TArray<FTransform>& TransformArray : RuleTransformArrays)
+		{
+			TransformArray.Reset();
+		}
+	}
+};
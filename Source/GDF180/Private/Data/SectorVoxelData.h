@@ -0,0 +1,87 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MeshRenderData.h"
+
+
+struct FVoxelBrick
+{
+	// Chunk within the sector horizontally, and counted from height zero vertically
+	FIntVector ChunkCoordinates;
+	
+	// Cells per axis, smaller than the chunk size for the last chunk of a sector that is not a multiple of it
+	FIntVector SizeInCells;
+	
+	// Density at the brick's grid points, with one extra point before each axis for the cubes it shares with its neighbors
+	TArray<float> DensityArray;
+	
+	TArray<int32> CubeVertexArray;
+	TArray<FVector3f> VertexArray;
+	TArray<uint32> IndexArray;
+	
+	FIntVector GetPointNum() const
+	{
+		return SizeInCells + FIntVector { 2 };
+	}
+	
+	// Grid points run from -1 to SizeInCells on each axis
+	int32 GetPointIndex(const int32 X, const int32 Y, const int32 Z) const
+	{
+		const FIntVector PointNum { GetPointNum() };
+		
+		return ((Z + 1) * PointNum.Y + Y + 1) * PointNum.X + X + 1;
+	}
+	
+	// Cubes run from -1 to SizeInCells - 1 on each axis
+	int32 GetCubeIndex(const int32 X, const int32 Y, const int32 Z) const
+	{
+		const FIntVector CubeNum { SizeInCells + FIntVector { 1 } };
+		
+		return ((Z + 1) * CubeNum.Y + Y + 1) * CubeNum.X + X + 1;
+	}
+};
+
+// Sparse bricks of the chunks that straddle a sector's surface, and the ground mesh contoured from them
+struct FSectorVoxelData
+{
+	bool bVolumetric { false };
+	
+	// Bricks past BrickNum are unused and only keep their allocations for the next sector
+	TArray<FVoxelBrick> BrickArray;
+	int32 BrickNum { 0 };
+	
+	// Column heights and 3D noise amplitudes over the sector's vertices plus one column before each axis
+	TArray<float> ColumnHeightArray;
+	TArray<float> ColumnAmplitudeArray;
+	
+	FMeshRenderData MeshRenderData;
+	
+	TArrayView<FVoxelBrick> GetBricks()
+	{
+		return TArrayView<FVoxelBrick> { BrickArray.GetData(), BrickNum };
+	}
+	
+	FVoxelBrick& AddBrick(const FIntVector ChunkCoordinates, const FIntVector SizeInCells)
+	{
+		if (BrickNum == BrickArray.Num())
+		{
+			BrickArray.AddDefaulted();
+		}
+		
+		FVoxelBrick& Brick { BrickArray[BrickNum++] };
+		Brick.ChunkCoordinates = ChunkCoordinates;
+		Brick.SizeInCells = SizeInCells;
+		
+		return Brick;
+	}
+	
+	void Clear()
+	{
+		bVolumetric = false;
+		BrickNum = 0;
+		
+		ColumnHeightArray.Reset();
+		ColumnAmplitudeArray.Reset();
+		MeshRenderData.Clear();
+	}
+};
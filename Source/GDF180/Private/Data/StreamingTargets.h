@@ -0,0 +1,13 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+struct FStreamingTargets
+{
+	FIntPoint PlayerSectorCoordinates;
+	FIntPoint HeadingSectorCoordinates;
+	FIntPoint ViewSectorCoordinates;
+
+	bool operator==(const FStreamingTargets& Other) const = default;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "TerrainBrush.generated.h"
+
+
+UENUM(BlueprintType)
+enum class ETerrainBrushMode : uint8
+{
+	Raise,
+	Lower,
+	Flatten,
+	Smooth
+};
+
+USTRUCT(BlueprintType)
+struct FTerrainBrush
+{
+	GENERATED_BODY()
+	
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	ETerrainBrushMode Mode { ETerrainBrushMode::Raise };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Radius { 500.0f };
+	
+	// Centimeters per application when raising or lowering, blend fraction toward the target when flattening or smoothing
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Strength { 20.0f };
+};
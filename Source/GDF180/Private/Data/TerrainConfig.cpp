@@ -1,4 +1,5 @@
 #include "TerrainConfig.h"
+#include "../Utility/NoiseProgramCompiler.h"
 
 UTerrainConfig::UTerrainConfig()
 	:
@@ -33,8 +34,28 @@ UTerrainConfig::UTerrainConfig()
 				},
 			}
 		},
-	}
-{}
+	},
+	CoarseLayerErrorTolerance { 5.0f },
+	NoiseCallsPerSample { 0.0f }
+{
+	UpdateNoiseCallsPerSample();
+}
+
+void UTerrainConfig::PostLoad()
+{
+	Super::PostLoad();
+
+	UpdateNoiseCallsPerSample();
+}
+
+#if WITH_EDITOR
+void UTerrainConfig::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	UpdateNoiseCallsPerSample();
+}
+#endif
 
 float UTerrainConfig::GetSectorSizeInCentimeters() const
 {
@@ -49,4 +70,9 @@ float UTerrainConfig::GetWorldSizeInCentimeters() const
 uint32 UTerrainConfig::GetSectorCellNum() const
 {
 	return SectorSizeInCells * SectorSizeInCells;
-}
\ No newline at end of file
+}
+
+void UTerrainConfig::UpdateNoiseCallsPerSample()
+{
+	NoiseCallsPerSample = FNoiseProgramCompiler::Run(this).GetNoiseCallsPerSample();
+}
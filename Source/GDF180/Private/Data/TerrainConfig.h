@@ -30,8 +30,24 @@ public:
 
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	TArray<FNoiseGroup> NoiseGroupArray;
+	
+	// Height error in centimeters allowed when sampling low-frequency layers on a coarse lattice, 0 disables
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
+	float CoarseLayerErrorTolerance;
+	
+	// Distinct noise evaluations per height sample after compiling the noise groups
+	UPROPERTY(VisibleAnywhere, Transient)
+	float NoiseCallsPerSample;
+
+	virtual void PostLoad() override;
+	
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 
 	float GetSectorSizeInCentimeters() const;
 	float GetWorldSizeInCentimeters() const;
 	uint32 GetSectorCellNum() const;
+	
+	void UpdateNoiseCallsPerSample();
 };
\ No newline at end of file
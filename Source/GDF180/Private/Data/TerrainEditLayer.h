@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+// Sparse height offsets over the procedural terrain, stored in sector-sized tiles of grid vertices
+struct FTerrainEditLayer
+{
+	mutable FRWLock Lock;
+	
+	int32 TileSize { 1 };
+	
+	TMap<FIntPoint, TArray<float>> TileMap;
+
+	void Initialize(const int32 InTileSize)
+	{
+		FWriteScopeLock WriteLock { Lock };
+		
+		TileSize = InTileSize;
+		
+		TileMap.Reset();
+	}
+	
+	FIntPoint GetTileCoordinates(const FIntPoint VertexCoordinates) const
+	{
+		return FIntPoint {
+			FMath::DivideAndRoundDown(VertexCoordinates.X, TileSize),
+			FMath::DivideAndRoundDown(VertexCoordinates.Y, TileSize)
+		};
+	}
+	
+	void AddHeightDeltas(const TConstArrayView<TPair<FIntPoint, float>> HeightDeltaArray)
+	{
+		FWriteScopeLock WriteLock { Lock };
+		
+		for (const auto& [VertexCoordinates, HeightDelta] : HeightDeltaArray)
+		{
+			const FIntPoint TileCoordinates { GetTileCoordinates(VertexCoordinates) };
+			
+			TArray<float>* Tile { TileMap.Find(TileCoordinates) };
+			
+			if (!Tile)
+			{
+				Tile = &TileMap.Add(TileCoordinates);
+				Tile->SetNumZeroed(TileSize * TileSize);
+			}
+			
+			const FIntPoint LocalCoordinates { VertexCoordinates - TileCoordinates * TileSize };
+			
+			(*Tile)[LocalCoordinates.Y * TileSize + LocalCoordinates.X] += HeightDelta;
+		}
+	}
+	
+	// Adds the stored offsets to a row-major height array covering VertexNum vertices from OriginInVertices
+	void ApplyToRegion(const FIntPoint OriginInVertices, const FIntPoint VertexNum, TArray<float>& HeightArray) const
+	{
+		FReadScopeLock ReadLock { Lock };
+		
+		if (TileMap.IsEmpty())
+		{
+			return;
+		}
+		
+		const FIntPoint MinTile { GetTileCoordinates(OriginInVertices) };
+		const FIntPoint MaxTile { GetTileCoordinates(OriginInVertices + VertexNum - FIntPoint { 1 }) };
+		
+		for (int32 TileY { MinTile.Y }; TileY <= MaxTile.Y; ++TileY)
+		{
+			for (int32 TileX { MinTile.X }; TileX <= MaxTile.X; ++TileX)
+			{
+				const TArray<float>* Tile { TileMap.Find({ TileX, TileY }) };
+				
+				if (!Tile)
+				{
+					continue;
+				}
+				
+				const FIntPoint TileOrigin { FIntPoint { TileX, TileY } * TileSize };
+				
+				const FIntPoint Min { TileOrigin.ComponentMax(OriginInVertices) };
+				const FIntPoint Max { (TileOrigin + FIntPoint { TileSize }).ComponentMin(OriginInVertices + VertexNum) };
+				
+				for (int32 Y { Min.Y }; Y < Max.Y; ++Y)
+				{
+					for (int32 X { Min.X }; X < Max.X; ++X)
+					{
+						HeightArray[(Y - OriginInVertices.Y) * VertexNum.X + X - OriginInVertices.X] += 
+							(*Tile)[(Y - TileOrigin.Y) * TileSize + X - TileOrigin.X];
+					}
+				}
+			}
+		}
+	}
+};
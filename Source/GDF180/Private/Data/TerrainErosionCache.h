@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+// Eroded terrain heights per sector, including the far row and column shared with the next sectors
+struct FTerrainErosionCache
+{
+	mutable FRWLock Lock;
+	
+	int32 SectorSizeInCells { 1 };
+	
+	TMap<FIntPoint, TArray<float>> SectorHeightMap;
+
+	void Initialize(const int32 InSectorSizeInCells)
+	{
+		FWriteScopeLock WriteLock { Lock };
+		
+		SectorSizeInCells = InSectorSizeInCells;
+		
+		SectorHeightMap.Reset();
+	}
+	
+	int32 GetSectorVertexNum() const
+	{
+		return (SectorSizeInCells + 1) * (SectorSizeInCells + 1);
+	}
+	
+	// SectorRect is inclusive
+	bool Contains(const FIntRect& SectorRect) const
+	{
+		FReadScopeLock ReadLock { Lock };
+		
+		for (int32 Y { SectorRect.Min.Y }; Y <= SectorRect.Max.Y; ++Y)
+		{
+			for (int32 X { SectorRect.Min.X }; X <= SectorRect.Max.X; ++X)
+			{
+				if (!SectorHeightMap.Contains({ X, Y }))
+				{
+					return false;
+				}
+			}
+		}
+		
+		return true;
+	}
+	
+	// Copies each sector's vertices out of a row-major height array covering VertexNum vertices from OriginInVertices
+	void Store(const FIntRect& SectorRect, const FIntPoint OriginInVertices, const FIntPoint VertexNum, const TArray<float>& HeightArray)
+	{
+		FWriteScopeLock WriteLock { Lock };
+		
+		ForEachSectorVertex(
+			SectorRect, 
+			OriginInVertices, 
+			VertexNum, 
+			[&](const FIntPoint SectorCoordinates, const int32 SectorVertexIndex, const int32 RegionVertexIndex)
+			{
+				TArray<float>& SectorHeightArray { SectorHeightMap.FindOrAdd(SectorCoordinates) };
+				
+				if (SectorHeightArray.Num() != GetSectorVertexNum())
+				{
+					SectorHeightArray.SetNumUninitialized(GetSectorVertexNum());
+				}
+				
+				SectorHeightArray[SectorVertexIndex] = HeightArray[RegionVertexIndex];
+			}
+		);
+	}
+	
+	void Load(const FIntRect& SectorRect, const FIntPoint OriginInVertices, const FIntPoint VertexNum, TArray<float>& HeightArray) const
+	{
+		FReadScopeLock ReadLock { Lock };
+		
+		ForEachSectorVertex(
+			SectorRect, 
+			OriginInVertices, 
+			VertexNum, 
+			[&](const FIntPoint SectorCoordinates, const int32 SectorVertexIndex, const int32 RegionVertexIndex)
+			{
+				HeightArray[RegionVertexIndex] = SectorHeightMap.FindChecked(SectorCoordinates)[SectorVertexIndex];
+			}
+		);
+	}
+	
+	void ForEachSectorVertex(
+		const FIntRect& SectorRect, 
+		const FIntPoint OriginInVertices, 
+		const FIntPoint VertexNum, 
+		const TFunctionRef<void(FIntPoint SectorCoordinates, int32 SectorVertexIndex, int32 RegionVertexIndex)> VertexFunction
+	) const {
+		for (int32 SectorY { SectorRect.Min.Y }; SectorY <= SectorRect.Max.Y; ++SectorY)
+		{
+			for (int32 SectorX { SectorRect.Min.X }; SectorX <= SectorRect.Max.X; ++SectorX)
+			{
+				const FIntPoint SectorOrigin { FIntPoint { SectorX, SectorY } * SectorSizeInCells - OriginInVertices };
+				
+				for (int32 Y { 0 }; Y <= SectorSizeInCells; ++Y)
+				{
+					for (int32 X { 0 }; X <= SectorSizeInCells; ++X)
+					{
+						VertexFunction(
+							{ SectorX, SectorY }, 
+							Y * (SectorSizeInCells + 1) + X, 
+							(SectorOrigin.Y + Y) * VertexNum.X + SectorOrigin.X + X
+						);
+					}
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+struct FTerrainSampleRegion
+{
+	FIntPoint OriginInCells { FIntPoint::ZeroValue };
+	FIntPoint SizeInCells { FIntPoint::ZeroValue };
+	
+	TArray<TArray<float>> GroupHeightArrays;
+	TArray<uint8> CellBiomeIndexArray;
+	
+	// Scratch storage reused by every layer and row sampled into this region
+	TArray<float> LayerNoiseArray;
+	TArray<float> LatticeArray;
+	TArray<float> LatticeRowArray;
+	TArray<float> CellWorldXArray;
+	
+	// Erosion state per vertex, with a second buffer for fields whose update reads neighbors
+	TArray<float> ErosionHeightArray;
+	TArray<float> WaterArray;
+	TArray<float> NextWaterArray;
+	TArray<float> SedimentArray;
+	TArray<float> NextSedimentArray;
+	TArray<float> FluxArrays[4];
+	
+	// Terrain heights over the region plus the apron around it that voxel sectors contour across their borders
+	FIntPoint VoxelOriginInCells { FIntPoint::ZeroValue };
+	FIntPoint VoxelSizeInCells { FIntPoint::ZeroValue };
+	TArray<float> VoxelHeightArray;
+
+	int32 GetVertexNum() const
+	{
+		return (SizeInCells.X + 1) * (SizeInCells.Y + 1);
+	}
+	
+	int32 GetVertexIndex(const FIntPoint GridPosition) const
+	{
+		return GridPosition.Y * (SizeInCells.X + 1) + GridPosition.X;
+	}
+	
+	int32 GetCellIndex(const FIntPoint GridPosition) const
+	{
+		return GridPosition.Y * SizeInCells.X + GridPosition.X;
+	}
+	
+	// Drops Border cells from every side of the sampled heights, keeping the row-major layout
+	void ShrinkHeights(const int32 Border)
+	{
+		const int32 SourceRowNum { SizeInCells.X + 1 };
+		
+		OriginInCells += FIntPoint { Border };
+		SizeInCells -= FIntPoint { 2 * Border };
+		
+		for (TArray<float>& HeightArray : GroupHeightArrays)
+		{
+			// Each row moves toward the front of the array, so copying in row order never overwrites unread rows
+			for (int32 Y { 0 }; Y <= SizeInCells.Y; ++Y)
+			{
+				FMemory::Memmove(
+					&HeightArray[GetVertexIndex({ 0, Y })],
+					&HeightArray[(Y + Border) * SourceRowNum + Border],
+					(SizeInCells.X + 1) * sizeof(float)
+				);
+			}
+			
+			HeightArray.SetNum(GetVertexNum(), EAllowShrinking::No);
+		}
+	}
+	
+	void Reserve(const int32 CellNum, const int32 VertexNum, const int32 RowCellNum, const int32 GroupNum)
+	{
+		GroupHeightArrays.SetNum(GroupNum);
+		
+		for (TArray<float>& HeightArray : GroupHeightArrays)
+		{
+			HeightArray.Reserve(VertexNum);
+		}
+		
+		CellBiomeIndexArray.Reserve(CellNum);
+		LayerNoiseArray.Reserve(VertexNum);
+		LatticeArray.Reserve(VertexNum);
+		LatticeRowArray.Reserve(VertexNum);
+		CellWorldXArray.Reserve(RowCellNum);
+	}
+
+	void Clear()
+	{
+		for (TArray<float>& HeightArray : GroupHeightArrays)
+		{
+			HeightArray.Reset();
+		}
+		
+		CellBiomeIndexArray.Reset();
+		LayerNoiseArray.Reset();
+		LatticeArray.Reset();
+		LatticeRowArray.Reset();
+		CellWorldXArray.Reset();
+		
+		ErosionHeightArray.Reset();
+		WaterArray.Reset();
+		NextWaterArray.Reset();
+		SedimentArray.Reset();
+		NextSedimentArray.Reset();
+		
+		for (TArray<float>& FluxArray : FluxArrays)
+		{
+			FluxArray.Reset();
+		}
+		
+		VoxelHeightArray.Reset();
+	}
+};
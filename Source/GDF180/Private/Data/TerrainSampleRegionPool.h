@@ -0,0 +1,42 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainSampleRegion.h"
+
+
+struct FTerrainSampleRegionPool
+{
+	FCriticalSection CriticalSection;
+	
+	TArray<TUniquePtr<FTerrainSampleRegion>> FreeRegionArray;
+
+	void Initialize(const int32 RegionNum, const int32 CellNum, const int32 VertexNum, const int32 RowCellNum, const int32 GroupNum)
+	{
+		FScopeLock Lock { &CriticalSection };
+		
+		FreeRegionArray.Reset();
+		
+		for (int32 RegionIndex { 0 }; RegionIndex < RegionNum; ++RegionIndex)
+		{
+			TUniquePtr<FTerrainSampleRegion>& Region { FreeRegionArray.Add_GetRef(MakeUnique<FTerrainSampleRegion>()) };
+			
+			Region->Reserve(CellNum, VertexNum, RowCellNum, GroupNum);
+		}
+	}
+	
+	TUniquePtr<FTerrainSampleRegion> Acquire()
+	{
+		FScopeLock Lock { &CriticalSection };
+		
+		return FreeRegionArray.IsEmpty() ? MakeUnique<FTerrainSampleRegion>() : FreeRegionArray.Pop(EAllowShrinking::No);
+	}
+	
+	void Release(TUniquePtr<FTerrainSampleRegion> Region)
+	{
+		Region->Clear();
+		
+		FScopeLock Lock { &CriticalSection };
+		
+		FreeRegionArray.Add(MoveTemp(Region));
+	}
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "TerrainStamp.generated.h"
+
+
+UENUM(BlueprintType)
+enum class ETerrainStampShape : uint8
+{
+	Road,
+	Pad,
+	Crater
+};
+
+USTRUCT(BlueprintType)
+struct FTerrainStamp
+{
+	GENERATED_BODY()
+	
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	ETerrainStampShape Shape { ETerrainStampShape::Road };
+	
+	// Road spline control points at their surface heights, or the center of a pad at its surface height or of a crater
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FVector> PointArray;
+	
+	// Half width of a road or radius of a crater
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Radius { 400.0f };
+	
+	// Half size of a pad before its yaw is applied
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FVector2D Extent { 1000.0, 1000.0 };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Yaw { 0.0f };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Depth { 300.0f };
+	
+	// Distance over which the stamp blends back into the surrounding terrain
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float Falloff { 500.0f };
+};
@@ -0,0 +1,367 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TerrainStamp.h"
+
+
+struct FCompiledTerrainStamp
+{
+	ETerrainStampShape Shape;
+	
+	// Tessellated road polyline, or a single center point
+	TArray<FVector3f> PointArray;
+	
+	FVector2f Extent;
+	FVector2f AxisX;
+	FVector2f AxisY;
+	
+	float Radius;
+	float Depth;
+	float Falloff;
+	
+	FBox2f Bounds;
+};
+
+struct FTerrainStampTileEntry
+{
+	int32 StampIndex { INDEX_NONE };
+	
+	// Road segments, by end point index, whose reach overlaps the tile
+	TArray<int32> SegmentIndexArray;
+};
+
+// Stamps evaluated over the terrain heights, indexed by the sector-sized tiles their bounds overlap
+struct FTerrainStampLayer
+{
+	mutable FRWLock Lock;
+	
+	int32 TileSizeInCells { 1 };
+	float CellSizeInCentimeters { 1.0f };
+	
+	TArray<FCompiledTerrainStamp> StampArray;
+	
+	// Stamps per tile in the order the stamps were added
+	TMap<FIntPoint, TArray<FTerrainStampTileEntry>> TileStampMap;
+
+	static constexpr int32 RoadSubdivisionNum { 8 };
+	
+	void Initialize(const int32 InTileSizeInCells, const float InCellSizeInCentimeters)
+	{
+		FWriteScopeLock WriteLock { Lock };
+		
+		TileSizeInCells = InTileSizeInCells;
+		CellSizeInCentimeters = InCellSizeInCentimeters;
+		
+		StampArray.Reset();
+		TileStampMap.Reset();
+	}
+	
+	FIntPoint GetTileCoordinates(const FVector2f WorldPosition) const
+	{
+		const float TileSizeInCentimeters { TileSizeInCells * CellSizeInCentimeters };
+		
+		return FIntPoint {
+			FMath::FloorToInt(WorldPosition.X / TileSizeInCentimeters),
+			FMath::FloorToInt(WorldPosition.Y / TileSizeInCentimeters)
+		};
+	}
+	
+	// Returns the inclusive rect of tiles the stamp overlaps, or an empty rect for an invalid stamp
+	FIntRect Add(const FTerrainStamp& Stamp)
+	{
+		if (Stamp.PointArray.IsEmpty())
+		{
+			return FIntRect {};
+		}
+		
+		FCompiledTerrainStamp CompiledStamp { Compile(Stamp) };
+		
+		const FIntRect TileRect { 
+			GetTileCoordinates(CompiledStamp.Bounds.Min), 
+			GetTileCoordinates(CompiledStamp.Bounds.Max) 
+		};
+		
+		FWriteScopeLock WriteLock { Lock };
+		
+		const int32 StampIndex { StampArray.Add(MoveTemp(CompiledStamp)) };
+		const FCompiledTerrainStamp& AddedStamp { StampArray[StampIndex] };
+		
+		const int32 TileRowNum { TileRect.Max.X - TileRect.Min.X + 1 };
+		
+		TArray<FTerrainStampTileEntry> TileEntryArray;
+		TileEntryArray.SetNum(TileRowNum * (TileRect.Max.Y - TileRect.Min.Y + 1));
+		
+		if (AddedStamp.Shape == ETerrainStampShape::Road)
+		{
+			const float Reach { AddedStamp.Radius + AddedStamp.Falloff };
+			
+			for (int32 Index { 1 }; Index < AddedStamp.PointArray.Num(); ++Index)
+			{
+				const FVector3f& A { AddedStamp.PointArray[Index - 1] };
+				const FVector3f& B { AddedStamp.PointArray[Index] };
+				
+				const FVector2f SegmentMin { FMath::Min(A.X, B.X) - Reach, FMath::Min(A.Y, B.Y) - Reach };
+				const FVector2f SegmentMax { FMath::Max(A.X, B.X) + Reach, FMath::Max(A.Y, B.Y) + Reach };
+				
+				const FIntPoint MinTile { GetTileCoordinates(SegmentMin).ComponentMax(TileRect.Min) };
+				const FIntPoint MaxTile { GetTileCoordinates(SegmentMax).ComponentMin(TileRect.Max) };
+				
+				for (int32 Y { MinTile.Y }; Y <= MaxTile.Y; ++Y)
+				{
+					for (int32 X { MinTile.X }; X <= MaxTile.X; ++X)
+					{
+						TileEntryArray[(Y - TileRect.Min.Y) * TileRowNum + X - TileRect.Min.X].SegmentIndexArray.Add(Index);
+					}
+				}
+			}
+		}
+		
+		for (int32 Y { TileRect.Min.Y }; Y <= TileRect.Max.Y; ++Y)
+		{
+			for (int32 X { TileRect.Min.X }; X <= TileRect.Max.X; ++X)
+			{
+				FTerrainStampTileEntry& TileEntry { TileEntryArray[(Y - TileRect.Min.Y) * TileRowNum + X - TileRect.Min.X] };
+				TileEntry.StampIndex = StampIndex;
+				
+				TileStampMap.FindOrAdd({ X, Y }).Add(MoveTemp(TileEntry));
+			}
+		}
+		
+		return TileRect;
+	}
+	
+	float ApplyToHeight(const FVector2f WorldPosition, float Height) const
+	{
+		FReadScopeLock ReadLock { Lock };
+		
+		if (const TArray<FTerrainStampTileEntry>* TileEntryArray { TileStampMap.Find(GetTileCoordinates(WorldPosition)) })
+		{
+			for (const FTerrainStampTileEntry& TileEntry : *TileEntryArray)
+			{
+				if (const FCompiledTerrainStamp& Stamp { StampArray[TileEntry.StampIndex] }; Stamp.Bounds.IsInside(WorldPosition))
+				{
+					Height = ApplyStamp(Stamp, TileEntry.SegmentIndexArray, WorldPosition, Height);
+				}
+			}
+		}
+		
+		return Height;
+	}
+	
+	// Applies the stamps to a row-major height array covering VertexNum grid vertices from OriginInVertices
+	void ApplyToRegion(const FIntPoint OriginInVertices, const FIntPoint VertexNum, TArray<float>& HeightArray) const
+	{
+		FReadScopeLock ReadLock { Lock };
+		
+		if (TileStampMap.IsEmpty())
+		{
+			return;
+		}
+		
+		const FIntPoint RegionMax { OriginInVertices + VertexNum };
+		
+		const FIntPoint MinTile { FIntPoint::DivideAndRoundDown(OriginInVertices, TileSizeInCells) };
+		const FIntPoint MaxTile { FIntPoint::DivideAndRoundDown(RegionMax - FIntPoint { 1 }, TileSizeInCells) };
+		
+		for (int32 TileY { MinTile.Y }; TileY <= MaxTile.Y; ++TileY)
+		{
+			for (int32 TileX { MinTile.X }; TileX <= MaxTile.X; ++TileX)
+			{
+				const TArray<FTerrainStampTileEntry>* TileEntryArray { TileStampMap.Find({ TileX, TileY }) };
+				
+				if (!TileEntryArray)
+				{
+					continue;
+				}
+				
+				const FIntPoint TileOrigin { FIntPoint { TileX, TileY } * TileSizeInCells };
+				
+				const FIntPoint TileMin { TileOrigin.ComponentMax(OriginInVertices) };
+				const FIntPoint TileMax { (TileOrigin + FIntPoint { TileSizeInCells }).ComponentMin(RegionMax) };
+				
+				// Each vertex belongs to one tile, so stamps reach it once and in the order they were added
+				for (const FTerrainStampTileEntry& TileEntry : *TileEntryArray)
+				{
+					const FCompiledTerrainStamp& Stamp { StampArray[TileEntry.StampIndex] };
+					
+					const FIntPoint Min { 
+						TileMin.ComponentMax(
+							FIntPoint { 
+								FMath::CeilToInt(Stamp.Bounds.Min.X / CellSizeInCentimeters), 
+								FMath::CeilToInt(Stamp.Bounds.Min.Y / CellSizeInCentimeters) 
+							}
+						) 
+					};
+					
+					const FIntPoint Max { 
+						TileMax.ComponentMin(
+							FIntPoint { 
+								FMath::FloorToInt(Stamp.Bounds.Max.X / CellSizeInCentimeters) + 1, 
+								FMath::FloorToInt(Stamp.Bounds.Max.Y / CellSizeInCentimeters) + 1 
+							}
+						) 
+					};
+					
+					for (int32 Y { Min.Y }; Y < Max.Y; ++Y)
+					{
+						for (int32 X { Min.X }; X < Max.X; ++X)
+						{
+							float& Height { HeightArray[(Y - OriginInVertices.Y) * VertexNum.X + X - OriginInVertices.X] };
+							
+							Height = ApplyStamp(
+								Stamp, 
+								TileEntry.SegmentIndexArray, 
+								FVector2f { X * CellSizeInCentimeters, Y * CellSizeInCentimeters }, 
+								Height
+							);
+						}
+					}
+				}
+			}
+		}
+	}
+	
+	static FCompiledTerrainStamp Compile(const FTerrainStamp& Stamp)
+	{
+		FCompiledTerrainStamp CompiledStamp;
+		CompiledStamp.Shape = Stamp.Shape;
+		CompiledStamp.Extent = FVector2f { Stamp.Extent };
+		CompiledStamp.AxisX = FVector2f { FMath::Cos(FMath::DegreesToRadians(Stamp.Yaw)), FMath::Sin(FMath::DegreesToRadians(Stamp.Yaw)) };
+		CompiledStamp.AxisY = FVector2f { -CompiledStamp.AxisX.Y, CompiledStamp.AxisX.X };
+		CompiledStamp.Radius = Stamp.Radius;
+		CompiledStamp.Depth = Stamp.Depth;
+		CompiledStamp.Falloff = FMath::Max(0.0f, Stamp.Falloff);
+		
+		const int32 PointNum { Stamp.PointArray.Num() };
+		
+		if (Stamp.Shape == ETerrainStampShape::Road && PointNum > 1)
+		{
+			// Catmull-Rom through the control points, with the end points repeated
+			auto GetPoint = [&](const int32 Index)
+			{
+				return FVector3f { Stamp.PointArray[FMath::Clamp(Index, 0, PointNum - 1)] };
+			};
+			
+			for (int32 Index { 0 }; Index < PointNum - 1; ++Index)
+			{
+				const FVector3f P0 { GetPoint(Index - 1) };
+				const FVector3f P1 { GetPoint(Index) };
+				const FVector3f P2 { GetPoint(Index + 1) };
+				const FVector3f P3 { GetPoint(Index + 2) };
+				
+				for (int32 Step { 0 }; Step < RoadSubdivisionNum; ++Step)
+				{
+					const float Alpha { static_cast<float>(Step) / RoadSubdivisionNum };
+					
+					CompiledStamp.PointArray.Add(
+						P1 + 0.5f * Alpha * (P2 - P0 + Alpha * (2.0f * P0 - 5.0f * P1 + 4.0f * P2 - P3 + Alpha * (3.0f * (P1 - P2) + P3 - P0)))
+					);
+				}
+			}
+			
+			CompiledStamp.PointArray.Add(GetPoint(PointNum - 1));
+		}
+		else
+		{
+			CompiledStamp.PointArray.Add(FVector3f { Stamp.PointArray[0] });
+		}
+		
+		float Reach { CompiledStamp.Radius + CompiledStamp.Falloff };
+		
+		if (Stamp.Shape == ETerrainStampShape::Pad)
+		{
+			Reach = CompiledStamp.Extent.Size() + CompiledStamp.Falloff;
+		}
+		
+		CompiledStamp.Bounds = FBox2f { ForceInit };
+		
+		for (const FVector3f& Point : CompiledStamp.PointArray)
+		{
+			CompiledStamp.Bounds += FVector2f { Point.X, Point.Y };
+		}
+		
+		CompiledStamp.Bounds = CompiledStamp.Bounds.ExpandBy(Reach);
+		
+		return CompiledStamp;
+	}
+	
+	// Roads only test the given segments, which must include every segment within reach of the position
+	static float ApplyStamp(
+		const FCompiledTerrainStamp& Stamp, 
+		const TConstArrayView<int32> SegmentIndexArray, 
+		const FVector2f WorldPosition, 
+		const float Height
+	) {
+		const FVector2f Center { Stamp.PointArray[0].X, Stamp.PointArray[0].Y };
+		
+		switch (Stamp.Shape)
+		{
+		case ETerrainStampShape::Road:
+			{
+				float MinDistance { TNumericLimits<float>::Max() };
+				float RoadHeight { Stamp.PointArray[0].Z };
+				
+				for (const int32 Index : SegmentIndexArray)
+				{
+					const FVector3f& A { Stamp.PointArray[Index - 1] };
+					const FVector3f& B { Stamp.PointArray[Index] };
+					
+					const FVector2f Segment { B.X - A.X, B.Y - A.Y };
+					const FVector2f Offset { WorldPosition.X - A.X, WorldPosition.Y - A.Y };
+					
+					const float Alpha { 
+						FMath::Clamp(FVector2f::DotProduct(Offset, Segment) / FMath::Max(Segment.SizeSquared(), UE_SMALL_NUMBER), 0.0f, 1.0f) 
+					};
+					
+					if (const float Distance { (Offset - Alpha * Segment).Size() }; Distance < MinDistance)
+					{
+						MinDistance = Distance;
+						RoadHeight = FMath::Lerp(A.Z, B.Z, Alpha);
+					}
+				}
+				
+				if (Stamp.PointArray.Num() == 1)
+				{
+					MinDistance = (WorldPosition - Center).Size();
+				}
+				
+				// Out of reach the result must not depend on which segments were tested
+				if (MinDistance >= Stamp.Radius + Stamp.Falloff)
+				{
+					return Height;
+				}
+				
+				return FMath::Lerp(RoadHeight, Height, FMath::SmoothStep(Stamp.Radius, Stamp.Radius + Stamp.Falloff, MinDistance));
+			}
+			
+		case ETerrainStampShape::Pad:
+			{
+				const FVector2f Offset { WorldPosition - Center };
+				
+				const FVector2f Outside {
+					FMath::Max(FMath::Abs(FVector2f::DotProduct(Offset, Stamp.AxisX)) - Stamp.Extent.X, 0.0f),
+					FMath::Max(FMath::Abs(FVector2f::DotProduct(Offset, Stamp.AxisY)) - Stamp.Extent.Y, 0.0f)
+				};
+				
+				return FMath::Lerp(Stamp.PointArray[0].Z, Height, FMath::SmoothStep(0.0f, Stamp.Falloff, Outside.Size()));
+			}
+			
+		case ETerrainStampShape::Crater:
+			{
+				const float Distance { (WorldPosition - Center).Size() };
+				
+				// Bowl below the surrounding terrain inside the radius and a raised rim fading out over the falloff
+				const float RimHeight { 0.25f * Stamp.Depth };
+				
+				if (Distance < Stamp.Radius)
+				{
+					return Height + RimHeight - Stamp.Depth * (1.0f - FMath::Square(Distance / Stamp.Radius));
+				}
+				
+				return Height + RimHeight * (1.0f - FMath::SmoothStep(Stamp.Radius, Stamp.Radius + Stamp.Falloff, Distance));
+			}
+		}
+		
+		return Height;
+	}
+};
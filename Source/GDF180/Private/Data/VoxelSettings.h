@@ -0,0 +1,32 @@
+#pragma once
+
+#include "VoxelSettings.generated.h"
+
+
+USTRUCT(BlueprintType)
+struct FVoxelSettings
+{
+	GENERATED_BODY()
+	
+	// Meshes sectors from a 3D density around the height field, which replaces erosion
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	bool bEnabled { false };
+	
+	// Cells per axis of a brick, the unit that is classified, stored and meshed
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	int32 ChunkSizeInCells { 8 };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float DensityPeriod { 2500.0f };
+	
+	// Largest distance in centimeters the 3D noise can move the surface from the height field
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float DensityAmplitude { 800.0f };
+	
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float MaskPeriod { 20000.0f };
+	
+	// Mask noise value below which the terrain stays a pure height field
+	UPROPERTY(EditAnywhere, BlueprintReadOnly)
+	float MaskThreshold { 0.3f };
+};
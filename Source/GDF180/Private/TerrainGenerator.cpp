@@ -1,20 +1,89 @@
 #include "TerrainGenerator.h"
+#include "Algo/AllOf.h"
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "EngineUtils.h"
+#include "Engine/AssetManager.h"
 #include "Engine/TextureCube.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "RenderingThread.h"
+#include "Actors/PlayerCharacter.h"
+#include "Utility/DynamicMeshConstructor.h"
+#include "Utility/HorizonMeshBuilder.h"
+#include "Utility/NoiseProgramCompiler.h"
+#include "Utility/RiverNetworkBuilder.h"
+#include "Utility/ScatterSampler.h"
+#include "Utility/TerrainEroder.h"
+#include "Utility/VoxelMesher.h"
 #include "Utility/StaticMeshConstructor.h"
 
-static TMap<int32, uint8> RegionIDToBiomeIndex;
+DECLARE_STATS_GROUP(TEXT("Terrain"), STATGROUP_Terrain, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT(TEXT("Commit Sectors"), STAT_CommitSectors, STATGROUP_Terrain);
+DECLARE_CYCLE_STAT(TEXT("Apply Terrain Brush"), STAT_ApplyTerrainBrush, STATGROUP_Terrain);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Commit Queue Depth"), STAT_CommitQueueDepth, STATGROUP_Terrain);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pending Generation"), STAT_PendingGeneration, STATGROUP_Terrain);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Time To First Playable (ms)"), STAT_TimeToFirstPlayable, STATGROUP_Terrain);
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkTerrainBrushCommand(
+	TEXT("Terrain.BenchmarkBrush"),
+	TEXT("Terrain.BenchmarkBrush [EditNum] [Raise|Lower|Flatten|Smooth]: measures brush edits per second around the player"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+		[](const TArray<FString>& ArgArray, UWorld* World)
+		{
+			FTerrainBrush Brush;
+			
+			if (ArgArray.IsValidIndex(1))
+			{
+				if (
+					const int64 ModeValue { StaticEnum<ETerrainBrushMode>()->GetValueByNameString(ArgArray[1]) };
+					ModeValue != INDEX_NONE
+				) {
+					Brush.Mode = static_cast<ETerrainBrushMode>(ModeValue);
+				}
+			}
+			
+			if (Brush.Mode == ETerrainBrushMode::Flatten || Brush.Mode == ETerrainBrushMode::Smooth)
+			{
+				Brush.Strength = 0.5f;
+			}
+			
+			const int32 EditNum { ArgArray.IsValidIndex(0) ? FCString::Atoi(*ArgArray[0]) : 1000 };
+			
+			for (TActorIterator<ATerrainGenerator> It { World }; It; ++It)
+			{
+				It->BenchmarkTerrainBrush(Brush, EditNum);
+			}
+		}
+	)
+);
 
 ATerrainGenerator::ATerrainGenerator()
 	:
-	TerrainConfig { LoadTerrainConfig(TEXT("/Game/Terrain/DA_TerrainConfig.DA_TerrainConfig")) },
-	BiomeSet { LoadBiomeSet(TEXT("/Game/Terrain/DA_BiomeSet.DA_BiomeSet")) },
-	TerrainMaterial { LoadMaterial(TEXT("/Game/Terrain/M_Terrain.M_Terrain")) },
-	WaterMaterial { LoadMaterial(TEXT("/Game/Terrain/M_Water.M_Water")) },
-	TerrainNoiseGroup { LoadNoiseGroup("Terrain", TerrainConfig->NoiseGroupArray) },
-	WaterNoiseGroup { LoadNoiseGroup("Water", TerrainConfig->NoiseGroupArray) }
+	TerrainConfigAsset { FSoftObjectPath { TEXT("/Game/Terrain/DA_TerrainConfig.DA_TerrainConfig") } },
+	BiomeSetAsset { FSoftObjectPath { TEXT("/Game/Terrain/DA_BiomeSet.DA_BiomeSet") } },
+	TerrainMaterialAsset { FSoftObjectPath { TEXT("/Game/Terrain/M_Terrain.M_Terrain") } },
+	WaterMaterialAsset { FSoftObjectPath { TEXT("/Game/Terrain/M_Water.M_Water") } },
+	PrefetchLookaheadTime { 2.0f },
+	MaxPrefetchDistanceInSectors { 2 },
+	CommitBudgetMilliseconds { 4.0f },
+	MaxGenerationBatchSectorNum { 9 },
+	bBuildFromMeshDescription { false },
+	SectorMeshBackend { ESectorMeshBackend::StaticMesh },
+	TerrainNoiseGroupIndex { INDEX_NONE },
+	WaterNoiseGroupIndex { INDEX_NONE },
+	MaxRunningGenerationNum { FMath::Max(1, FPlatformMisc::NumberOfWorkerThreadsToSpawn()) },
+	PendingRequestNum { 0 },
+	ErosionHaloInCells { 0 },
+	VoxelApronInCells { 0 },
+	StartupTime { 0.0 },
+	bAwaitingFirstPlayableFrame { false }
 {
-	PrimaryActorTick.bCanEverTick = false;
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 	
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 	RootComponent->Mobility = EComponentMobility::Static;
@@ -23,7 +92,6 @@ ATerrainGenerator::ATerrainGenerator()
 	SetActorLocation(FVector::ZeroVector);
 
 	SetupSkyLightComponent();
-	SetupNoiseGeneration();
 }
 
 void ATerrainGenerator::OnConstruction(const FTransform& Transform)
@@ -35,87 +103,228 @@ void ATerrainGenerator::BeginPlay()
 {
 	Super::BeginPlay();
 
-	GetWorld()->GetTimerManager().SetTimer(
-		StreamingTimer,
-		this,
-		&ATerrainGenerator::UpdateVisibleSectors,
-		0.25f,
-		true
-	);
+	StartupTime = FPlatformTime::Seconds();
 	
-	const FVector SpawnLocation { 
-		TerrainConfig->GetWorldSizeInCentimeters() / 2.0f, 
-		TerrainConfig->GetWorldSizeInCentimeters() / 2.0f, 
-		1000.0f 
-	};
-
-	SetPlayerPosition(SpawnLocation);
+	SetPlayerControlEnabled(false);
+	LoadConfigAssets();
 }
 
-TObjectPtr<UTerrainConfig> ATerrainGenerator::LoadTerrainConfig(const TCHAR* Path)
+void ATerrainGenerator::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	if (
-		const ConstructorHelpers::FObjectFinder<UTerrainConfig> ObjectFinder { Path };
-		ObjectFinder.Succeeded()
-	) {
-		UTerrainConfig* TerrainConfig { ObjectFinder.Object };
-		
-		UE_LOG(LogTemp, Log, TEXT("Loaded: %s"), *TerrainConfig->GetName());
+	if (ConfigAssetsHandle.IsValid())
+	{
+		ConfigAssetsHandle->CancelHandle();
+		ConfigAssetsHandle.Reset();
+	}
+	
+	if (TrackedComponent.IsValid())
+	{
+		TrackedComponent->TransformUpdated.Remove(TransformUpdatedHandle);
+	}
 
-		return TerrainConfig;
+	TrackedComponent.Reset();
+	TransformUpdatedHandle.Reset();
+	
+	for (FSectorSlot& Slot : SectorGrid.SlotArray)
+	{
+		if (Slot.Request)
+		{
+			Slot.Request->bCancelled = true;
+			Slot.Request.Reset();
+		}
 	}
 	
-	UE_LOG(LogTemp, Warning, TEXT("Failed: %s"), Path);
+	UE::Tasks::Wait(GenerationTaskArray);
+	
+	GenerationTaskArray.Reset();
+	QueuedRequestArray.Reset();
+	PendingRequestNum = 0;
+	GeneratedRequestQueue.Empty();
+	
+	Super::EndPlay(EndPlayReason);
+}
 
-	return nullptr;
+void ATerrainGenerator::LoadConfigAssets()
+{
+	const TArray<FSoftObjectPath> AssetPathArray {
+		TerrainConfigAsset.ToSoftObjectPath(),
+		BiomeSetAsset.ToSoftObjectPath(),
+		TerrainMaterialAsset.ToSoftObjectPath(),
+		WaterMaterialAsset.ToSoftObjectPath()
+	};
+	
+	ConfigAssetsHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		AssetPathArray,
+		FStreamableDelegate::CreateUObject(this, &ATerrainGenerator::OnConfigAssetsLoaded)
+	);
 }
 
-TObjectPtr<UBiomeSet> ATerrainGenerator::LoadBiomeSet(const TCHAR* Path)
+void ATerrainGenerator::OnConfigAssetsLoaded()
 {
-	if (
-		const ConstructorHelpers::FObjectFinder<UBiomeSet> ObjectFinder { Path };
-		ObjectFinder.Succeeded()
-	) {
-		UBiomeSet* BiomeSet { ObjectFinder.Object };
+	TerrainConfig = TerrainConfigAsset.Get();
+	BiomeSet = BiomeSetAsset.Get();
+	TerrainMaterial = TerrainMaterialAsset.Get();
+	WaterMaterial = WaterMaterialAsset.Get();
+	
+	for (const UObject* Asset : TArray<const UObject*> { TerrainConfig, BiomeSet, TerrainMaterial, WaterMaterial })
+	{
+		if (Asset)
+		{
+			UE_LOG(LogTemp, Log, TEXT("Loaded: %s"), *Asset->GetName());
+		}
+	}
+	
+	if (!TerrainConfig || !BiomeSet)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Failed: %s"), !TerrainConfig ? *TerrainConfigAsset.ToString() : *BiomeSetAsset.ToString());
 		
-		UE_LOG(LogTemp, Log, TEXT("Loaded: %s"), *BiomeSet->GetName());
-
-		return BiomeSet;
+		// Control was disabled while loading, so the player is not left frozen without terrain
+		SetPlayerControlEnabled(true);
+		
+		return;
 	}
 	
-	UE_LOG(LogTemp, Warning, TEXT("Failed: %s"), Path);
-
-	return nullptr;
+	SetupNoiseGeneration();
+	SetupBiomeWeights();
+	SetupNoiseProgram();
+	SetupSectorGrid();
+	SetupScatterRules();
+	SetupErosion();
+	SetupRiverNetwork();
+	SetupVoxelTerrain();
+	SetupSampleRegionPool();
+	SetupHorizon();
+	
+	const FVector2f SpawnPosition { 
+		TerrainConfig->GetWorldSizeInCentimeters() / 2.0f, 
+		TerrainConfig->GetWorldSizeInCentimeters() / 2.0f 
+	};
+	
+	GenerateSpawnSectors(GetSectorCoordinates(FVector { SpawnPosition.X, SpawnPosition.Y, 0.0f }));
+	
+	const APawn* PlayerPawn { UGameplayStatics::GetPlayerPawn(GetWorld(), 0) };
+	
+	const float SpawnClearance { 10.0f + (PlayerPawn ? PlayerPawn->GetSimpleCollisionHalfHeight() : 0.0f) };
+	
+	// Generated heights include erosion, which a point sample of the noise does not
+	const TOptional<float> SpawnHeight { 
+		FindVertexHeight(
+			FIntPoint { 
+				FMath::RoundToInt(SpawnPosition.X / TerrainConfig->CellSizeInCentimeters), 
+				FMath::RoundToInt(SpawnPosition.Y / TerrainConfig->CellSizeInCentimeters) 
+			}
+		) 
+	};
+	
+	SetPlayerPosition(
+		FVector {
+			SpawnPosition.X,
+			SpawnPosition.Y,
+			SpawnHeight.Get(SampleHeight(SpawnPosition, TerrainNoiseGroupIndex)) + SpawnClearance
+		}
+	);
+	
+	SetupPlayerTracking();
+	SetPlayerControlEnabled(true);
+	
+	bAwaitingFirstPlayableFrame = true;
+	
+	SetActorTickEnabled(true);
 }
 
-TObjectPtr<UMaterialInterface> ATerrainGenerator::LoadMaterial(const TCHAR* Path)
+void ATerrainGenerator::GenerateSpawnSectors(const FIntPoint SpawnSectorCoordinates)
 {
-	if (
-		const ConstructorHelpers::FObjectFinder<UMaterialInterface> ObjectFinder { Path };
-		ObjectFinder.Succeeded()
-	) {
-		TObjectPtr MaterialInterface { ObjectFinder.Object };
-		UE_LOG(LogTemp, Log, TEXT("Loaded: %s"), *MaterialInterface->GetName());
-
-		return MaterialInterface;
+	TArray<FSectorSlot*> SpawnSlotArray;
+	
+	for (const FIntPoint& SectorCoordinates : ComputeVisibleSet(SpawnSectorCoordinates, TerrainConfig))
+	{
+		SpawnSlotArray.Add(&ClaimSectorSlot(SectorCoordinates));
 	}
 	
-	UE_LOG(LogTemp, Warning, TEXT("Failed: %s"), Path);
-
-	return nullptr;
+	const std::atomic<bool> bCancelled { false };
+	
+	ParallelFor(
+		SpawnSlotArray.Num(),
+		[&](const int32 SlotIndex)
+		{
+			FSectorSlot& Slot { *SpawnSlotArray[SlotIndex] };
+			
+			Slot.bHasRenderData = GenerateSectorRenderData(Slot.SectorCoordinates, Slot.SectorRenderData, bCancelled);
+		}
+	);
+	
+	for (FSectorSlot* Slot : SpawnSlotArray)
+	{
+		// Sectors that failed to sample are left without render data rather than committed from stale buffers
+		if (Slot->bHasRenderData)
+		{
+			CommitSector(*Slot);
+		}
+	}
+	
+	UE_LOG(
+		LogTemp, 
+		Log, 
+		TEXT("Spawn Sectors: %d in %.1f ms"), 
+		SpawnSlotArray.Num(), 
+		1000.0 * (FPlatformTime::Seconds() - StartupTime)
+	);
 }
 
-const FNoiseGroup* ATerrainGenerator::LoadNoiseGroup(const FString& Name, const TArray<FNoiseGroup>& NoiseGroupArray)
+void ATerrainGenerator::SetPlayerControlEnabled(const bool bEnabled) const
 {
-	for (const auto& NoiseGroup : NoiseGroupArray)
+	APawn* PlayerPawn { UGameplayStatics::GetPlayerPawn(GetWorld(), 0) };
+
+	if (!PlayerPawn)
+	{
+		return;
+	}
+	
+	if (bEnabled)
+	{
+		PlayerPawn->EnableInput(nullptr);
+	}
+	else
+	{
+		PlayerPawn->DisableInput(nullptr);
+	}
+	
+	if (const ACharacter* Character { Cast<ACharacter>(PlayerPawn) })
 	{
-		if (NoiseGroup.Name.Equals(Name, ESearchCase::IgnoreCase))
+		// Suspending the tick keeps the pawn in place without changing its movement mode
+		if (UCharacterMovementComponent* CharacterMovementComponent { Character->GetCharacterMovement() })
 		{
-			return &NoiseGroup;
+			CharacterMovementComponent->SetComponentTickEnabled(bEnabled);
 		}
 	}
+}
+
+void ATerrainGenerator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	
+	if (bAwaitingFirstPlayableFrame)
+	{
+		bAwaitingFirstPlayableFrame = false;
+		
+		const double TimeToFirstPlayable { 1000.0 * (FPlatformTime::Seconds() - StartupTime) };
+		
+		SET_FLOAT_STAT(STAT_TimeToFirstPlayable, TimeToFirstPlayable);
+		
+		UE_LOG(LogTemp, Log, TEXT("Time To First Playable: %.1f ms"), TimeToFirstPlayable);
+	}
 	
-	return nullptr;
+	ReceiveGeneratedSectors();
+	DispatchSectorGeneration();
+	CommitSectors();
+	
+	SET_DWORD_STAT(STAT_CommitQueueDepth, CommitQueue.Num());
+	SET_DWORD_STAT(STAT_PendingGeneration, PendingRequestNum);
+
+	if (CommitQueue.IsEmpty() && PendingRequestNum == 0)
+	{
+		SetActorTickEnabled(false);
+	}
 }
 
 void ATerrainGenerator::SetupSkyLightComponent()
@@ -149,9 +358,6 @@ void ATerrainGenerator::SetupNoiseGeneration()
 	UE_LOG(LogTemp, Log, TEXT("Terrain Seed: %d"), TerrainSeed);
 	UE_LOG(LogTemp, Log, TEXT("Biome Seed: %d"), BiomeSeed);
 	
-	TerrainNoise.SetSeed(TerrainSeed);
-	TerrainNoise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
-	
 	BiomeNoise.SetSeed(BiomeSeed);
 	BiomeNoise.SetNoiseType(FastNoiseLite::NoiseType_Cellular);
 	BiomeNoise.SetCellularDistanceFunction(FastNoiseLite::CellularDistanceFunction_Euclidean);
@@ -159,316 +365,2127 @@ void ATerrainGenerator::SetupNoiseGeneration()
 	BiomeNoise.SetFrequency(BiomeSet->GetFrequency());
 }
 
-TObjectPtr<USectorComponent> ATerrainGenerator::GenerateSector(const FIntPoint SectorCoordinates)
+void ATerrainGenerator::SetupBiomeWeights()
 {
-	if (TObjectPtr<USectorComponent>* SectorComponentPointer { ActiveSectorMap.Find(SectorCoordinates) })
+	RingBiomeWeightTableArray.Reset(BiomeSet->RingDefinitionArray.Num());
+	
+	for (const FRingDefinition& RingDefinition : BiomeSet->RingDefinitionArray)
 	{
-		return *SectorComponentPointer;
+		TArray<TPair<uint8, float>>& WeightTable { RingBiomeWeightTableArray.AddDefaulted_GetRef() };
+		
+		for (const TPair<uint8, float>& Pair : RingDefinition.BiomeWeightMap)
+		{
+			WeightTable.Add(Pair);
+		}
+		
+		// Map order is not stable, so biomes are sorted by index to keep the picks deterministic
+		WeightTable.Sort(
+			[](const TPair<uint8, float>& A, const TPair<uint8, float>& B)
+			{
+				return A.Key < B.Key;
+			}
+		);
+		
+		float Accumulator { 0.0f };
+		
+		for (TPair<uint8, float>& Pair : WeightTable)
+		{
+			Accumulator += Pair.Value;
+			Pair.Value = Accumulator;
+		}
 	}
-	
-	const FName SectorName { *FString::Printf(TEXT("S_%d_%d"), SectorCoordinates.X, SectorCoordinates.Y) };
-	
-	const FVector3f WorldLocation { SectorCoordinates * TerrainConfig->GetSectorSizeInCentimeters() };
-
-	TObjectPtr<USectorComponent> NewSectorComponent {
-		NewObject<USectorComponent>(
-			this,
-			USectorComponent::StaticClass(),
-			SectorName
-		)
-	};
-
-	AddInstanceComponent(NewSectorComponent.Get());
-	
-	NewSectorComponent->AttachToComponent(RootComponent.Get(), FAttachmentTransformRules::KeepRelativeTransform);
-	NewSectorComponent->SetRelativeLocation(FVector { WorldLocation });
-	NewSectorComponent->RegisterComponent();
-	NewSectorComponent->Initialize(SectorCoordinates, WorldLocation);
-
-	ActiveSectorMap.Add(NewSectorComponent->SectorCoordinates, NewSectorComponent);
-
-	return NewSectorComponent;
 }
 
-void ATerrainGenerator::GenerateSectorRenderData(const TObjectPtr<USectorComponent> SectorComponent) {
-	FSectorRenderData& SectorRenderData { SectorRenderDataMap.FindOrAdd(SectorComponent->SectorCoordinates) };
-	SectorRenderData.Clear();
-
-	SectorRenderData.SectorCoordinates = SectorComponent->SectorCoordinates;
-
-	int32 IndexBase { 0 };
-
-	const FVector2f SectorWorldPosition { SectorComponent->WorldLocation.X, SectorComponent->WorldLocation.Y };
+void ATerrainGenerator::SetupPlayerTracking()
+{
+	APawn* PlayerPawn { UGameplayStatics::GetPlayerPawn(GetWorld(), 0) };
 
-	for (int32 Y { 0 }; Y < TerrainConfig->SectorSizeInCells; ++Y)
+	if (!PlayerPawn || !PlayerPawn->GetRootComponent())
 	{
-	    for (int32 X { 0 }; X < TerrainConfig->SectorSizeInCells; ++X)
-	    {
-	        FVector2f VertexPosition00 { X * TerrainConfig->CellSizeInCentimeters, Y * TerrainConfig->CellSizeInCentimeters };
-	        FVector2f VertexPosition10 { (X + 1) * TerrainConfig->CellSizeInCentimeters, Y * TerrainConfig->CellSizeInCentimeters };
-	        FVector2f VertexPosition11 { (X + 1) * TerrainConfig->CellSizeInCentimeters, ( Y+ 1) * TerrainConfig->CellSizeInCentimeters };
-	        FVector2f VertexPosition01 { X * TerrainConfig->CellSizeInCentimeters, (Y + 1) * TerrainConfig->CellSizeInCentimeters };
-
-	        FVector2f CellWorldPosition { 
-	        	SectorWorldPosition + FVector2f{
-		            (X + 0.5f) * TerrainConfig->CellSizeInCentimeters,
-		            (Y + 0.5f) * TerrainConfig->CellSizeInCentimeters
-		        }
-	        };
-
-	        const uint8 BiomeIndex { SampleBiomeIndex(CellWorldPosition) };
-	        const float BiomeIndexMax { BiomeSet->BiomeDefinitionArray.Num() - 1.0f };
-	    	
-	        const float EncodedBiomeIndex { 
-	        	BiomeIndexMax > 0.0f ? static_cast<float>(BiomeIndex) / BiomeIndexMax : 0.0f
-	        };
-
-	        FVector4f VertexColor { EncodedBiomeIndex, 0, 0, 1 };
-
-	        auto AddVertex = [&](const FVector2f& LocalPosition)
-	        {
-	            const FVector2f WorldPosition { SectorWorldPosition + LocalPosition };
-	        	
-	            const float TerrainHeight { SampleHeight(WorldPosition, TerrainNoiseGroup) };
-	        	const float WaterHeight { SampleHeight(WorldPosition, WaterNoiseGroup) };
-	        	
-	        	const FVector3f TerrainVertexPosition { LocalPosition.X, LocalPosition.Y, TerrainHeight };
-	        	const FVector3f WaterVertexPosition { LocalPosition.X, LocalPosition.Y, WaterHeight };
-
-	            const FVector2f UV {
-	                LocalPosition.X / (TerrainConfig->SectorSizeInCells * TerrainConfig->CellSizeInCentimeters),
-	                LocalPosition.Y / (TerrainConfig->SectorSizeInCells * TerrainConfig->CellSizeInCentimeters)
-	            };
-
-	            SectorRenderData.GroundMeshRenderData.VertexArray.Add(TerrainVertexPosition);
-	            SectorRenderData.GroundMeshRenderData.UVArray.Add(UV);
-	            SectorRenderData.GroundMeshRenderData.VertexColorArray.Add(VertexColor);
-	        	
-	        	SectorRenderData.WaterMeshRenderData.VertexArray.Add(WaterVertexPosition);
-	        	SectorRenderData.WaterMeshRenderData.UVArray.Add(UV);
-	        	SectorRenderData.WaterMeshRenderData.VertexColorArray.Add(VertexColor);
-	        };
-
-	        int32 Index0 { IndexBase + 0 };
-	        int32 Index1 { IndexBase + 1 };
-	        int32 Index2 { IndexBase + 2 };
-	        int32 Index3 { IndexBase + 3 };
+		UE_LOG(LogTemp, Warning, TEXT("Player pawn not found."));
+		return;
+	}
 
-	        AddVertex(VertexPosition00);
-	        AddVertex(VertexPosition10);
-	        AddVertex(VertexPosition11);
-	        AddVertex(VertexPosition01);
+	TrackedComponent = PlayerPawn->GetRootComponent();
+	TransformUpdatedHandle = TrackedComponent->TransformUpdated.AddUObject(this, &ATerrainGenerator::OnPlayerTransformUpdated);
 
-	        SectorRenderData.GroundMeshRenderData.IndexArray.Append({
-	            Index0, Index2, Index1,
-	            Index0, Index3, Index2
-	        });
-	    	
-	    	SectorRenderData.WaterMeshRenderData.IndexArray.Append({
-				Index0, Index2, Index1,
-				Index0, Index3, Index2
-			});
+	UpdateVisibleSectors(ComputeStreamingTargets(PlayerPawn));
+}
 
-	        IndexBase += 4;
-	    }
+void ATerrainGenerator::OnPlayerTransformUpdated(
+	USceneComponent* UpdatedComponent, 
+	EUpdateTransformFlags UpdateTransformFlags, 
+	ETeleportType TeleportType
+) {
+	const APawn* PlayerPawn { Cast<APawn>(UpdatedComponent->GetOwner()) };
+	
+	if (!PlayerPawn)
+	{
+		return;
+	}
+	
+	if (
+		const FStreamingTargets NewStreamingTargets { ComputeStreamingTargets(PlayerPawn) };
+		!StreamingTargets.IsSet() || NewStreamingTargets != StreamingTargets.GetValue()
+	) {
+		UpdateVisibleSectors(NewStreamingTargets);
 	}
 }
 
-float ATerrainGenerator::SampleHeight(const FVector2f WorldPosition, const FNoiseGroup* NoiseGroup)
+FStreamingTargets ATerrainGenerator::ComputeStreamingTargets(const APawn* PlayerPawn) const
 {
-	float NoiseValue { 0.0f };
+	const FVector Location { PlayerPawn->GetActorLocation() };
+	
+	FVector Velocity { PlayerPawn->GetVelocity() };
+	FVector ViewDirection { PlayerPawn->GetControlRotation().Vector() };
+	float MaxMoveSpeed { 0.0f };
 
-	for (const auto& [Weight, Period, Amplitude] : NoiseGroup->NoiseLayerArray)
+	if (const APlayerCharacter* PlayerCharacter { Cast<APlayerCharacter>(PlayerPawn) })
 	{
-		const float Frequency { 1.0f / Period };
-		
-		TerrainNoise.SetFrequency(Frequency);
+		ViewDirection = PlayerCharacter->GetViewDirection();
+		MaxMoveSpeed = PlayerCharacter->GetMaxMoveSpeed();
+	}
+	
+	Velocity.Z = 0.0f;
+	ViewDirection = ViewDirection.GetSafeNormal2D();
 
-		constexpr float XScale { 1.01f };
-		constexpr float XOffset { 17.123f };
-		
-		constexpr float YScale { 0.99f };
-		constexpr float YOffset { 43.512f };
+	const FIntPoint PlayerSectorCoordinates { GetSectorCoordinates(Location) };
+
+	auto ClampPrefetchTarget = [&](const FVector& TargetLocation)
+	{
+		const FIntPoint Offset { GetSectorCoordinates(TargetLocation) - PlayerSectorCoordinates };
 		
-		const float LayerNoiseValue {
-			Amplitude *
-			TerrainNoise.GetNoise(
-				WorldPosition.X * XScale + XOffset, WorldPosition.Y * YScale + YOffset
-			)
+		return PlayerSectorCoordinates + FIntPoint {
+			FMath::Clamp(Offset.X, -MaxPrefetchDistanceInSectors, MaxPrefetchDistanceInSectors),
+			FMath::Clamp(Offset.Y, -MaxPrefetchDistanceInSectors, MaxPrefetchDistanceInSectors)
 		};
-	
-		NoiseValue += Weight * LayerNoiseValue;
-	}
+	};
 
-	return NoiseValue;
+	return FStreamingTargets {
+		PlayerSectorCoordinates,
+		ClampPrefetchTarget(Location + Velocity * PrefetchLookaheadTime),
+		ClampPrefetchTarget(Location + ViewDirection * MaxMoveSpeed * PrefetchLookaheadTime)
+	};
 }
 
-void ATerrainGenerator::UpdateVisibleSectors()
+void ATerrainGenerator::SetupSectorGrid()
 {
-	const FIntPoint PlayerSectorCoordinates { GetPlayerSector() };
-	const TSet VisibleSectorCoordinatesSet { ComputeVisibleSet(PlayerSectorCoordinates, TerrainConfig) };
-
-	AddMissingSectors(VisibleSectorCoordinatesSet);
-	RemoveExpiredSectors(VisibleSectorCoordinatesSet);
+	// Every streamed sector lies within this Chebyshev distance of the player's sector
+	const int32 StreamingRadius { ViewRadius + MaxPrefetchDistanceInSectors };
+	
+	SectorGrid.Initialize(2 * StreamingRadius + 1);
+	
+	// Edit tiles line up with sectors so a sector's own vertices rarely span more than four tiles
+	TerrainEditLayer.Initialize(TerrainConfig->SectorSizeInCells);
+	TerrainStampLayer.Initialize(TerrainConfig->SectorSizeInCells, TerrainConfig->CellSizeInCentimeters);
+	
+	for (const FTerrainStamp& Stamp : TerrainStampArray)
+	{
+		TerrainStampLayer.Add(Stamp);
+	}
 }
 
-FIntPoint ATerrainGenerator::GetPlayerSector() const
+void ATerrainGenerator::SetupSampleRegionPool()
 {
-	const TObjectPtr PlayerPawn { GetWorld()->GetFirstPlayerController()->GetPawn() };
-	const FVector Location { PlayerPawn->GetActorLocation() };
-
-	const FIntPoint SectorPosition {
-		FMath::FloorToInt(Location.X / TerrainConfig->GetSectorSizeInCentimeters()),
-		FMath::FloorToInt(Location.Y / TerrainConfig->GetSectorSizeInCentimeters())
-	};
-
-	return SectorPosition;
+	// Regions are sampled with the erosion halo or the voxel apron on every side, so this runs after both are set up
+	const int32 PaddingInCells { 2 * FMath::Max(ErosionHaloInCells, VoxelApronInCells) };
+	const int32 PaddedSectorSizeInCells { TerrainConfig->SectorSizeInCells + PaddingInCells };
+	
+	// A single row of sectors has the most padding of any batch rectangle, so it bounds the cell and vertex counts
+	const int32 BatchRowCellNum { MaxGenerationBatchSectorNum * TerrainConfig->SectorSizeInCells + PaddingInCells };
+	const int32 BatchCellNum { BatchRowCellNum * PaddedSectorSizeInCells };
+	const int32 BatchVertexNum { (BatchRowCellNum + 1) * (PaddedSectorSizeInCells + 1) };
+	
+	SampleRegionPool.Initialize(
+		MaxRunningGenerationNum,
+		BatchCellNum,
+		BatchVertexNum,
+		BatchRowCellNum,
+		NoiseProgram.GroupArray.Num()
+	);
 }
 
-TSet<FIntPoint> ATerrainGenerator::ComputeVisibleSet(const FIntPoint& PlayerSector, const TObjectPtr<UTerrainConfig> TerrainConfig)
+void ATerrainGenerator::SetupScatterRules()
 {
-	TSet<FIntPoint> VisibleSectorCoordinates;
-
-	for (int X { -ViewRadius }; X <= ViewRadius; ++X)
+	ScatterRuleArray.Reset();
+	
+	for (int32 BiomeIndex { 0 }; BiomeIndex < BiomeSet->BiomeDefinitionArray.Num(); ++BiomeIndex)
 	{
-		for (int Y { -ViewRadius }; Y <= ViewRadius; ++Y)
+		for (int32 RuleIndex { 0 }; RuleIndex < BiomeSet->BiomeDefinitionArray[BiomeIndex].ScatterRuleArray.Num(); ++RuleIndex)
 		{
-			if (
-				const FIntPoint SectorCoordinates { PlayerSector + FIntPoint(X, Y) };
-				SectorCoordinates.X >= 0 &&
-				SectorCoordinates.Y >= 0 &&
-				SectorCoordinates.X < TerrainConfig->WorldSizeInSectors &&
-				SectorCoordinates.Y < TerrainConfig->WorldSizeInSectors
-			) {
-				VisibleSectorCoordinates.Add(SectorCoordinates);
-			}
+			ScatterRuleArray.Emplace(static_cast<uint8>(BiomeIndex), RuleIndex);
 		}
 	}
-
-	return VisibleSectorCoordinates;
+	
+	UE_LOG(LogTemp, Log, TEXT("Scatter Rules: %d"), ScatterRuleArray.Num());
 }
 
-void ATerrainGenerator::AddMissingSectors(const TSet<FIntPoint>& VisibleSectorCoordinatesSet)
+void ATerrainGenerator::SetupErosion()
 {
-	for (const FIntPoint& SectorCoordinates : VisibleSectorCoordinatesSet)
+	ErosionCache.Initialize(TerrainConfig->SectorSizeInCells);
+	
+	// Keeping the halo on the coarse lattice makes a haloed region sample the same heights as any other region
+	ErosionHaloInCells = Align(FTerrainEroder::GetHaloInCells(ErosionSettings), NoiseProgram.GetMaxLatticeStep());
+	
+	if (ErosionSettings.bEnabled)
 	{
-		TObjectPtr<USectorComponent> SectorComponent;
+		UE_LOG(LogTemp, Log, TEXT("Erosion Halo: %d cells"), ErosionHaloInCells);
+	}
+}
 
-		if (const TObjectPtr<USectorComponent>* FindResult { ActiveSectorMap.Find(SectorCoordinates) })
-		{
-			SectorComponent = *FindResult;      
-		}
-		else
-		{
-			SectorComponent = GenerateSector(SectorCoordinates);
-			
-			ActiveSectorMap.Add(SectorComponent->SectorCoordinates, SectorComponent);
-		}
-		
-		if (!SectorRenderDataMap.Contains(SectorComponent->SectorCoordinates))
-		{
-			GenerateSectorRenderData(SectorComponent);
-		}
-		
-		if (!StaticMeshMap.Contains(SectorComponent->SectorCoordinates))
+void ATerrainGenerator::SetupRiverNetwork()
+{
+	if (!RiverSettings.bEnabled || TerrainNoiseGroupIndex == INDEX_NONE || WaterNoiseGroupIndex == INDEX_NONE)
+	{
+		if (RiverSettings.bEnabled)
 		{
-			FSectorRenderData& SectorRenderData { SectorRenderDataMap[SectorComponent->SectorCoordinates] };
-			
-			FSectorMeshes SectorMeshes {
-				FStaticMeshConstructor::Run(
-					this,
-					*FString::Printf(TEXT("SMG_%d_%d"), SectorComponent->SectorCoordinates.X, SectorComponent->SectorCoordinates.Y),
-					SectorRenderData.GroundMeshRenderData,
-					true
-				),
-				FStaticMeshConstructor::Run(
-					this,
-					*FString::Printf(TEXT("SMW_%d_%d"), SectorComponent->SectorCoordinates.X, SectorComponent->SectorCoordinates.Y),
-					SectorRenderData.WaterMeshRenderData,
-					false
-				)
-			};
-			
-			StaticMeshMap.Add(SectorComponent->SectorCoordinates, SectorMeshes);
+			// River surfaces are raised into the water group's heights rather than meshed on their own
+			UE_LOG(LogTemp, Warning, TEXT("River Network: disabled, it needs both a Terrain and a Water noise group"));
 		}
 		
-		const auto& [GroundStaticMesh, WaterStaticMesh]
-		{
-			StaticMeshMap[SectorComponent->SectorCoordinates]
-		};
-		
-		SectorComponent->GroundStaticMeshComponent->SetStaticMesh(GroundStaticMesh.Get());
-		SectorComponent->GroundStaticMeshComponent->SetRelativeLocation(FVector::ZeroVector);
-		SectorComponent->GroundStaticMeshComponent->SetMaterial(0, TerrainMaterial.Get());
-		SectorComponent->GroundStaticMeshComponent->MarkRenderStateDirty();
-		
-		UMaterialInstanceDynamic* TerrainMaterialInstance 
-		{ 
-			SectorComponent->GroundStaticMeshComponent->CreateDynamicMaterialInstance(0) 
-		};
-		
-		TerrainMaterialInstance->SetScalarParameterValue(TEXT("BiomeIndexMax"), BiomeSet->BiomeDefinitionArray.Num() - 1);
-		
-		SectorComponent->WaterStaticMeshComponent->SetStaticMesh(WaterStaticMesh.Get());
-		SectorComponent->WaterStaticMeshComponent->SetRelativeLocation(FVector::ZeroVector);
-		SectorComponent->WaterStaticMeshComponent->SetMaterial(0, WaterMaterial.Get());
-		SectorComponent->WaterStaticMeshComponent->SetTranslucentSortPriority(1);
-		SectorComponent->WaterStaticMeshComponent->SetCastShadow(false);
-		SectorComponent->WaterStaticMeshComponent->SetReceivesDecals(false);
-		SectorComponent->WaterStaticMeshComponent->MarkRenderStateDirty();
+		RiverNetwork = FRiverNetwork {};
+		return;
 	}
+	
+	const double StartTime { FPlatformTime::Seconds() };
+	
+	RiverNetwork = FRiverNetworkBuilder::Run(RiverSettings, TerrainConfig, NoiseProgram, TerrainNoiseGroupIndex);
+	
+	UE_LOG(
+		LogTemp, 
+		Log, 
+		TEXT("River Network: %d segments, %d tile entries in %.1f ms, drawn through the water mesh"), 
+		RiverNetwork.SegmentArray.Num(), 
+		RiverNetwork.SegmentIndexArray.Num(), 
+		(FPlatformTime::Seconds() - StartTime) * 1000.0
+	);
 }
 
-void ATerrainGenerator::RemoveExpiredSectors(const TSet<FIntPoint>& VisibleSectorCoordinatesSet)
+void ATerrainGenerator::SetupVoxelTerrain()
 {
-	for (auto Iterator { ActiveSectorMap.CreateIterator() }; Iterator; ++Iterator)
+	VoxelApronInCells = 0;
+	
+	if (!VoxelSettings.bEnabled)
+	{
+		return;
+	}
+	
+	VoxelDensityNoise.SetSeed(TerrainConfig->Seed + 2);
+	VoxelDensityNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+	VoxelDensityNoise.SetFrequency(1.0f / FMath::Max(VoxelSettings.DensityPeriod, 1.0f));
+	
+	VoxelMaskNoise.SetSeed(TerrainConfig->Seed + 3);
+	VoxelMaskNoise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+	VoxelMaskNoise.SetFrequency(1.0f / FMath::Max(VoxelSettings.MaskPeriod, 1.0f));
+	
+	// One cell is enough for the shared cubes, the rest keeps the apron on the coarse lattice
+	VoxelApronInCells = NoiseProgram.GetMaxLatticeStep();
+	
+	if (ErosionSettings.bEnabled)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Erosion is disabled in voxel mode"));
+	}
+	
+	UE_LOG(LogTemp, Log, TEXT("Voxel Apron: %d cells"), VoxelApronInCells);
+}
+
+void ATerrainGenerator::SetupHorizon()
+{
+	if (!HorizonSettings.bEnabled)
+	{
+		return;
+	}
+	
+	const double StartTime { FPlatformTime::Seconds() };
+	
+	const float BiomeIndexMax { BiomeSet->BiomeDefinitionArray.Num() - 1.0f };
+	
+	auto GetVertexColor = [&](const FVector2f WorldPosition)
+	{
+		return FVector4f { BiomeIndexMax > 0.0f ? SampleBiomeIndex(WorldPosition) / BiomeIndexMax : 0.0f, 0, 0, 1 };
+	};
+	
+	FHorizonMeshBuilder::Run(HorizonSettings, TerrainConfig, NoiseProgram, TerrainNoiseGroupIndex, GetVertexColor, HorizonGroundMeshRenderData);
+	FHorizonMeshBuilder::Run(HorizonSettings, TerrainConfig, NoiseProgram, WaterNoiseGroupIndex, GetVertexColor, HorizonWaterMeshRenderData);
+	
+	if (!HorizonGroundMeshComponent)
+	{
+		HorizonGroundMeshComponent = NewObject<UDynamicMeshComponent>(this, TEXT("HorizonGroundMesh"));
+		HorizonGroundMeshComponent->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+		HorizonGroundMeshComponent->RegisterComponent();
+		
+		HorizonWaterMeshComponent = NewObject<UDynamicMeshComponent>(this, TEXT("HorizonWaterMesh"));
+		HorizonWaterMeshComponent->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+		HorizonWaterMeshComponent->RegisterComponent();
+	}
+	
+	FDynamicMeshConstructor::Run(HorizonGroundMeshComponent, HorizonGroundMeshRenderData);
+	FDynamicMeshConstructor::Run(HorizonWaterMeshComponent, HorizonWaterMeshRenderData);
+	
+	// A fresh dynamic mesh numbers its triangles in the order they were appended, and a missing group has none
+	auto ResetTriangleIDs = [](const FMeshRenderData& MeshRenderData, TArray<int32>& TriangleIDArray)
+	{
+		TriangleIDArray.SetNumUninitialized(MeshRenderData.IndexArray.Num() / 3);
+		
+		for (int32 TriangleIndex { 0 }; TriangleIndex < TriangleIDArray.Num(); ++TriangleIndex)
+		{
+			TriangleIDArray[TriangleIndex] = TriangleIndex;
+		}
+	};
+	
+	ResetTriangleIDs(HorizonGroundMeshRenderData, HorizonGroundTriangleIDArray);
+	ResetTriangleIDs(HorizonWaterMeshRenderData, HorizonWaterTriangleIDArray);
+	
+	HorizonCoverageArray.SetNumZeroed(FMath::Square(FHorizonMeshBuilder::GetCellNum(HorizonSettings, TerrainConfig)));
+	
+	for (const FSectorSlot& Slot : SectorGrid.SlotArray)
+	{
+		if (Slot.SectorComponent)
+		{
+			UpdateHorizon(Slot.SectorCoordinates, 1);
+		}
+	}
+	
+	SetupSectorMaterials(HorizonGroundMeshComponent, HorizonWaterMeshComponent);
+	
+	HorizonGroundMeshComponent->SetCastShadow(false);
+	
+	UE_LOG(
+		LogTemp, 
+		Log, 
+		TEXT("Horizon: %d cells in %.1f ms"), 
+		HorizonCoverageArray.Num(), 
+		(FPlatformTime::Seconds() - StartTime) * 1000.0
+	);
+}
+
+void ATerrainGenerator::UpdateHorizon(const FIntPoint SectorCoordinates, const int32 CoverageDelta)
+{
+	if (!HorizonGroundMeshComponent || HorizonCoverageArray.IsEmpty())
+	{
+		return;
+	}
+	
+	const int32 SectorSize { TerrainConfig->SectorSizeInCells };
+	const int32 CellNum { FHorizonMeshBuilder::GetCellNum(HorizonSettings, TerrainConfig) };
+	
+	const FIntRect SectorCellRect { SectorCoordinates * SectorSize, (SectorCoordinates + FIntPoint { 1 }) * SectorSize };
+	const FIntRect HorizonCellRect { FHorizonMeshBuilder::GetOverlappedCellRect(HorizonSettings, SectorCellRect) };
+	
+	TArray<int32, TInlineAllocator<64>> HiddenTriangleArray;
+	TArray<int32, TInlineAllocator<64>> ShownTriangleArray;
+	
+	// Cells follow the committed sectors, so the horizon never opens a gap while streamed sectors are still generating
+	for (int32 Y { FMath::Max(0, HorizonCellRect.Min.Y) }; Y < FMath::Min(CellNum, HorizonCellRect.Max.Y); ++Y)
+	{
+		for (int32 X { FMath::Max(0, HorizonCellRect.Min.X) }; X < FMath::Min(CellNum, HorizonCellRect.Max.X); ++X)
+		{
+			const int32 CellIndex { Y * CellNum + X };
+			const int32 SectorNum { FHorizonMeshBuilder::GetOverlappedSectorNum(HorizonSettings, TerrainConfig, { X, Y }) };
+			
+			const bool bWasHidden { HorizonCoverageArray[CellIndex] == SectorNum };
+			
+			HorizonCoverageArray[CellIndex] += CoverageDelta;
+			
+			if (const bool bHidden { HorizonCoverageArray[CellIndex] == SectorNum }; bHidden != bWasHidden)
+			{
+				(bHidden ? HiddenTriangleArray : ShownTriangleArray).Append({ 2 * CellIndex, 2 * CellIndex + 1 });
+			}
+		}
+	}
+	
+	if (HiddenTriangleArray.IsEmpty() && ShownTriangleArray.IsEmpty())
+	{
+		return;
+	}
+	
+	FDynamicMeshConstructor::UpdateTriangles(
+		HorizonGroundMeshComponent, 
+		HorizonGroundMeshRenderData, 
+		HiddenTriangleArray, 
+		ShownTriangleArray, 
+		HorizonGroundTriangleIDArray
+	);
+	
+	FDynamicMeshConstructor::UpdateTriangles(
+		HorizonWaterMeshComponent, 
+		HorizonWaterMeshRenderData, 
+		HiddenTriangleArray, 
+		ShownTriangleArray, 
+		HorizonWaterTriangleIDArray
+	);
+}
+
+void ATerrainGenerator::SetupNoiseProgram()
+{
+	NoiseProgram = FNoiseProgramCompiler::Run(TerrainConfig);
+	
+	TerrainNoiseGroupIndex = NoiseProgram.FindGroupIndex(TEXT("Terrain"));
+	WaterNoiseGroupIndex = NoiseProgram.FindGroupIndex(TEXT("Water"));
+	
+	if (TerrainNoiseGroupIndex == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Terrain noise group is missing, sectors will not be generated"));
+	}
+	
+	if (WaterNoiseGroupIndex == INDEX_NONE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Water noise group is missing, water is flat at zero height"));
+	}
+	
+	UE_LOG(LogTemp, Log, TEXT("Noise Calls Per Sample: %.2f"), NoiseProgram.GetNoiseCallsPerSample());
+}
+
+TObjectPtr<USectorComponent> ATerrainGenerator::GenerateSector(FSectorSlot& Slot)
+{
+	if (Slot.SectorComponent)
+	{
+		return Slot.SectorComponent;
+	}
+	
+	const FIntPoint SectorCoordinates { Slot.SectorCoordinates };
+	
+	const FName SectorName { *FString::Printf(TEXT("S_%d_%d"), SectorCoordinates.X, SectorCoordinates.Y) };
+	
+	const FVector3f WorldLocation { SectorCoordinates * TerrainConfig->GetSectorSizeInCentimeters() };
+
+	TObjectPtr<USectorComponent> NewSectorComponent {
+		NewObject<USectorComponent>(
+			this,
+			USectorComponent::StaticClass(),
+			SectorName
+		)
+	};
+
+	AddInstanceComponent(NewSectorComponent.Get());
+	
+	NewSectorComponent->AttachToComponent(RootComponent.Get(), FAttachmentTransformRules::KeepRelativeTransform);
+	NewSectorComponent->SetRelativeLocation(FVector { WorldLocation });
+	NewSectorComponent->RegisterComponent();
+	NewSectorComponent->Initialize(SectorCoordinates, WorldLocation);
+
+	Slot.SectorComponent = NewSectorComponent;
+
+	return NewSectorComponent;
+}
+
+FSectorSlot& ATerrainGenerator::ClaimSectorSlot(const FIntPoint SectorCoordinates)
+{
+	FSectorSlot& Slot { SectorGrid.GetSlot(SectorCoordinates) };
+
+	if (Slot.bClaimed && Slot.SectorCoordinates == SectorCoordinates)
+	{
+		return Slot;
+	}
+
+	if (Slot.bClaimed)
+	{
+		ReleaseSectorSlot(Slot);
+	}
+
+	Slot.bClaimed = true;
+	Slot.SectorCoordinates = SectorCoordinates;
+
+	return Slot;
+}
+
+void ATerrainGenerator::ReleaseSectorSlot(FSectorSlot& Slot)
+{
+	CancelSectorGeneration(Slot);
+	DestroySector(Slot);
+	
+	// Render data keeps its allocations for the next sector that claims the slot
+	Slot.SectorRenderData.Clear();
+	ReleaseSectorMeshes(Slot);
+	
+	Slot.bHasRenderData = false;
+	Slot.bBuildingMeshes = false;
+	Slot.bMeshesOutdated = false;
+	Slot.bClaimed = false;
+}
+
+bool ATerrainGenerator::GenerateSectorRenderData(
+	const FIntPoint SectorCoordinates, 
+	FSectorRenderData& SectorRenderData, 
+	const std::atomic<bool>& bCancelled
+) const {
+	TUniquePtr<FTerrainSampleRegion> Region { SampleRegionPool.Acquire() };
+	
+	const bool bSampled {
+		SampleRegion(
+			SectorCoordinates * TerrainConfig->SectorSizeInCells,
+			FIntPoint { TerrainConfig->SectorSizeInCells },
+			*Region,
+			[&bCancelled] { return bCancelled.load(std::memory_order_relaxed); }
+		)
+	};
+	
+	if (bSampled)
+	{
+		BuildSectorRenderData(*Region, SectorCoordinates, SectorRenderData);
+	}
+	
+	SampleRegionPool.Release(MoveTemp(Region));
+
+	return bSampled;
+}
+
+bool ATerrainGenerator::SampleRegion(
+	const FIntPoint OriginInCells,
+	const FIntPoint SizeInCells,
+	FTerrainSampleRegion& Region,
+	const TFunctionRef<bool()> IsCancelled
+) const {
+	Region.Clear();
+	
+	const FIntRect SectorRect { 
+		OriginInCells / TerrainConfig->SectorSizeInCells, 
+		(OriginInCells + SizeInCells) / TerrainConfig->SectorSizeInCells - FIntPoint { 1 } 
+	};
+	
+	// Eroded heights in the voxel apron would not match the neighboring sectors' own, so voxel mode skips erosion
+	const bool bErosionEnabled { ErosionSettings.bEnabled && ErosionSettings.IterationNum > 0 && !VoxelSettings.bEnabled };
+	const bool bErode { bErosionEnabled && !ErosionCache.Contains(SectorRect) };
+	
+	// Eroded heights near the region border depend on terrain outside it, so a halo is eroded and discarded
+	const int32 HaloInCells { bErode ? ErosionHaloInCells : VoxelApronInCells };
+	
+	Region.OriginInCells = OriginInCells - FIntPoint { HaloInCells };
+	Region.SizeInCells = SizeInCells + FIntPoint { 2 * HaloInCells };
+	
+	const float CellSize { TerrainConfig->CellSizeInCentimeters };
+
+	FBiomeRegionCandidates RegionCandidates;
+	
+	GatherRegionCandidates(
+		(FVector2f { OriginInCells } + 0.5f) * CellSize,
+		(FVector2f { OriginInCells + SizeInCells } - 0.5f) * CellSize,
+		RegionCandidates
+	);
+	
+	SampleHeightFields(Region);
+	
+	if (!Region.GroupHeightArrays.IsValidIndex(TerrainNoiseGroupIndex))
+	{
+		return false;
+	}
+	
+	TArray<float>& TerrainHeightArray { Region.GroupHeightArrays[TerrainNoiseGroupIndex] };
+	
+	if (bErode)
+	{
+		FTerrainEroder::Run(ErosionSettings, CellSize, Region, TerrainHeightArray);
+		
+		Region.ShrinkHeights(HaloInCells);
+		
+		ErosionCache.Store(SectorRect, Region.OriginInCells, SizeInCells + FIntPoint { 1 }, TerrainHeightArray);
+	}
+	else if (bErosionEnabled)
+	{
+		ErosionCache.Load(SectorRect, Region.OriginInCells, SizeInCells + FIntPoint { 1 }, TerrainHeightArray);
+	}
+	
+	// Height layers are pointwise, so applying them before the voxel apron is dropped gives the apron its final heights
+	if (Region.GroupHeightArrays.IsValidIndex(WaterNoiseGroupIndex))
+	{
+		RiverNetwork.ApplyToRegion(
+			Region.OriginInCells, 
+			Region.SizeInCells + FIntPoint { 1 }, 
+			TerrainHeightArray, 
+			Region.GroupHeightArrays[WaterNoiseGroupIndex]
+		);
+	}
+	
+	TerrainStampLayer.ApplyToRegion(Region.OriginInCells, Region.SizeInCells + FIntPoint { 1 }, TerrainHeightArray);
+	TerrainEditLayer.ApplyToRegion(Region.OriginInCells, Region.SizeInCells + FIntPoint { 1 }, TerrainHeightArray);
+	
+	if (HaloInCells > 0 && !bErode)
+	{
+		Region.VoxelOriginInCells = Region.OriginInCells;
+		Region.VoxelSizeInCells = Region.SizeInCells;
+		
+		// Appending into the pooled buffer keeps its capacity, where assignment would reallocate
+		Region.VoxelHeightArray.Reset();
+		Region.VoxelHeightArray.Append(TerrainHeightArray);
+		
+		Region.ShrinkHeights(HaloInCells);
+	}
+	
+	if (IsCancelled())
+	{
+		return false;
+	}
+	
+	TArray<float>& CellWorldXArray { Region.CellWorldXArray };
+	CellWorldXArray.SetNumUninitialized(SizeInCells.X);
+	
+	Region.CellBiomeIndexArray.SetNumUninitialized(SizeInCells.X * SizeInCells.Y);
+	
+	for (int32 X { 0 }; X < SizeInCells.X; ++X)
+	{
+		CellWorldXArray[X] = (OriginInCells.X + X + 0.5f) * CellSize;
+	}
+
+	ForEachRowChunk(
+		SizeInCells.Y,
+		SizeInCells.X,
+		[&](const int32 RowBegin, const int32 RowEnd)
+		{
+			for (int32 Y { RowBegin }; Y < RowEnd; ++Y)
+			{
+				if (IsCancelled())
+				{
+					return;
+				}
+				
+				SampleBiomeIndices(
+					CellWorldXArray, 
+					(OriginInCells.Y + Y + 0.5f) * CellSize, 
+					RegionCandidates, 
+					TArrayView<uint8> { &Region.CellBiomeIndexArray[Region.GetCellIndex({ 0, Y })], SizeInCells.X }
+				);
+			}
+		}
+	);
+	
+	return !IsCancelled();
+}
+
+void ATerrainGenerator::BuildSectorRenderData(
+	const FTerrainSampleRegion& Region,
+	const FIntPoint SectorCoordinates,
+	FSectorRenderData& SectorRenderData
+) const {
+	SectorRenderData.Clear();
+
+	SectorRenderData.SectorCoordinates = SectorCoordinates;
+
+	const int32 SectorSize { TerrainConfig->SectorSizeInCells };
+	const int32 CellNum { SectorSize * SectorSize };
+	
+	FMeshRenderData& GroundMeshRenderData { SectorRenderData.GroundMeshRenderData };
+	FMeshRenderData& WaterMeshRenderData { SectorRenderData.WaterMeshRenderData };
+
+	// Four vertices and six indices per cell, laid out in cell order so every row chunk owns a fixed slice
+	for (FMeshRenderData* MeshRenderData : { &GroundMeshRenderData, &WaterMeshRenderData })
+	{
+		MeshRenderData->VertexArray.SetNumUninitialized(4 * CellNum);
+		MeshRenderData->UVArray.SetNumUninitialized(4 * CellNum);
+		MeshRenderData->VertexColorArray.SetNumUninitialized(4 * CellNum);
+		MeshRenderData->IndexArray.SetNumUninitialized(6 * CellNum);
+	}
+	
+	// Offset of this sector's first cell within the sampled region
+	const FIntPoint RegionOffset { SectorCoordinates * SectorSize - Region.OriginInCells };
+	
+	const TArray<float>& TerrainHeightArray { Region.GroupHeightArrays[TerrainNoiseGroupIndex] };
+	
+	// Matches FNoiseProgram::SampleGroup, which samples a missing group as zero
+	const TArray<float>* WaterHeightArray { 
+		Region.GroupHeightArrays.IsValidIndex(WaterNoiseGroupIndex) ? &Region.GroupHeightArrays[WaterNoiseGroupIndex] : nullptr 
+	};
+	
+	const float BiomeIndexMax { BiomeSet->BiomeDefinitionArray.Num() - 1.0f };
+
+	ForEachRowChunk(
+		SectorSize,
+		SectorSize,
+		[&](const int32 RowBegin, const int32 RowEnd)
+		{
+			for (int32 Y { RowBegin }; Y < RowEnd; ++Y)
+			{
+			    for (int32 X { 0 }; X < SectorSize; ++X)
+			    {
+			    	const int32 CellIndex { Y * SectorSize + X };
+			    	const int32 IndexBase { 4 * CellIndex };
+			    	
+			        const uint8 BiomeIndex { Region.CellBiomeIndexArray[Region.GetCellIndex(RegionOffset + FIntPoint { X, Y })] };
+			    	
+			        const float EncodedBiomeIndex { 
+			        	BiomeIndexMax > 0.0f ? static_cast<float>(BiomeIndex) / BiomeIndexMax : 0.0f
+			        };
+
+			        const FVector4f VertexColor { EncodedBiomeIndex, 0, 0, 1 };
+
+			        auto SetVertex = [&](const int32 Corner, const FIntPoint GridPosition)
+			        {
+			            const FVector2f LocalPosition { 
+			            	GridPosition.X * TerrainConfig->CellSizeInCentimeters, 
+			            	GridPosition.Y * TerrainConfig->CellSizeInCentimeters 
+			            };
+			        	
+			        	const int32 RegionVertexIndex { Region.GetVertexIndex(RegionOffset + GridPosition) };
+			        	const int32 VertexIndex { IndexBase + Corner };
+
+			            const FVector2f UV {
+			                LocalPosition.X / (SectorSize * TerrainConfig->CellSizeInCentimeters),
+			                LocalPosition.Y / (SectorSize * TerrainConfig->CellSizeInCentimeters)
+			            };
+
+			            GroundMeshRenderData.VertexArray[VertexIndex] = FVector3f { LocalPosition.X, LocalPosition.Y, TerrainHeightArray[RegionVertexIndex] };
+			            GroundMeshRenderData.UVArray[VertexIndex] = UV;
+			            GroundMeshRenderData.VertexColorArray[VertexIndex] = VertexColor;
+			        	
+			        	WaterMeshRenderData.VertexArray[VertexIndex] = FVector3f { 
+			        		LocalPosition.X, 
+			        		LocalPosition.Y, 
+			        		WaterHeightArray ? (*WaterHeightArray)[RegionVertexIndex] : 0.0f 
+			        	};
+			        	WaterMeshRenderData.UVArray[VertexIndex] = UV;
+			        	WaterMeshRenderData.VertexColorArray[VertexIndex] = VertexColor;
+			        };
+
+			        SetVertex(0, { X, Y });
+			        SetVertex(1, { X + 1, Y });
+			        SetVertex(2, { X + 1, Y + 1 });
+			        SetVertex(3, { X, Y + 1 });
+
+			    	const uint32 VertexBase { static_cast<uint32>(IndexBase) };
+			    	
+			    	const uint32 CellIndexArray[] {
+			            VertexBase + 0, VertexBase + 2, VertexBase + 1,
+			            VertexBase + 0, VertexBase + 3, VertexBase + 2
+			    	};
+			    	
+			    	FMemory::Memcpy(&GroundMeshRenderData.IndexArray[6 * CellIndex], CellIndexArray, sizeof(CellIndexArray));
+			    	FMemory::Memcpy(&WaterMeshRenderData.IndexArray[6 * CellIndex], CellIndexArray, sizeof(CellIndexArray));
+			    }
+			}
+		}
+	);
+	
+	FScatterSampler::Run(
+		BiomeSet->BiomeDefinitionArray,
+		ScatterRuleArray,
+		TerrainConfig->Seed,
+		Region,
+		TerrainHeightArray,
+		WaterHeightArray,
+		FIntRect { SectorCoordinates * SectorSize, SectorCoordinates * SectorSize + FIntPoint { SectorSize } },
+		TerrainConfig->CellSizeInCentimeters,
+		SectorRenderData.ScatterData
+	);
+	
+	if (VoxelSettings.bEnabled)
+	{
+		FVoxelMesher::Run(
+			VoxelSettings,
+			VoxelDensityNoise,
+			VoxelMaskNoise,
+			Region,
+			SectorCoordinates,
+			SectorSize,
+			TerrainConfig->CellSizeInCentimeters,
+			BiomeIndexMax,
+			SectorRenderData.VoxelData
+		);
+	}
+}
+
+void ATerrainGenerator::ForEachRowChunk(
+	const int32 RowNum, 
+	const int32 CellsPerRow, 
+	const TFunctionRef<void(int32 RowBegin, int32 RowEnd)> ChunkFunction
+) {
+	const int32 RowsPerChunk { FMath::Max(1, MinRowChunkCellNum / FMath::Max(1, CellsPerRow)) };
+	const int32 ChunkNum { FMath::DivideAndRoundUp(RowNum, RowsPerChunk) };
+	
+	ParallelFor(
+		ChunkNum,
+		[&](const int32 ChunkIndex)
+		{
+			const int32 RowBegin { ChunkIndex * RowsPerChunk };
+			
+			ChunkFunction(RowBegin, FMath::Min(RowBegin + RowsPerChunk, RowNum));
+		},
+		ChunkNum > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread
+	);
+}
+
+float ATerrainGenerator::SampleHeight(const FVector2f WorldPosition, const int32 NoiseGroupIndex) const
+{
+	const float Height { NoiseProgram.SampleGroup(NoiseGroupIndex, WorldPosition) };
+	
+	return NoiseGroupIndex == TerrainNoiseGroupIndex ? TerrainStampLayer.ApplyToHeight(WorldPosition, Height) : Height;
+}
+
+void ATerrainGenerator::SampleHeightFields(FTerrainSampleRegion& Region) const
+{
+	const FIntPoint VerticesPerAxis { Region.SizeInCells + FIntPoint { 1 } };
+	const int32 VertexNum { Region.GetVertexNum() };
+	
+	Region.GroupHeightArrays.SetNum(NoiseProgram.GroupArray.Num());
+
+	for (TArray<float>& HeightArray : Region.GroupHeightArrays)
+	{
+		HeightArray.SetNumZeroed(VertexNum);
+	}
+	
+	TArray<float>& LayerNoiseArray { Region.LayerNoiseArray };
+	LayerNoiseArray.SetNumUninitialized(VertexNum);
+
+	for (int32 LayerIndex { 0 }; LayerIndex < NoiseProgram.LayerArray.Num(); ++LayerIndex)
+	{
+		if (const int32 LatticeStep { NoiseProgram.LayerArray[LayerIndex].LatticeStep }; LatticeStep > 1)
+		{
+			SampleCoarseNoiseLayer(Region, LayerIndex, LatticeStep);
+		}
+		else
+		{
+			ForEachRowChunk(
+				VerticesPerAxis.Y,
+				VerticesPerAxis.X,
+				[&](const int32 RowBegin, const int32 RowEnd)
+				{
+					for (int32 Y { RowBegin }; Y < RowEnd; ++Y)
+					{
+						for (int32 X { 0 }; X < VerticesPerAxis.X; ++X)
+						{
+							const FVector2f WorldPosition { 
+								(Region.OriginInCells.X + X) * TerrainConfig->CellSizeInCentimeters, 
+								(Region.OriginInCells.Y + Y) * TerrainConfig->CellSizeInCentimeters 
+							};
+							
+							LayerNoiseArray[Region.GetVertexIndex({ X, Y })] = NoiseProgram.SampleLayer(LayerIndex, WorldPosition);
+						}
+					}
+				}
+			);
+		}
+
+		for (int32 GroupIndex { 0 }; GroupIndex < NoiseProgram.GroupArray.Num(); ++GroupIndex)
+		{
+			for (const auto& [TermLayerIndex, Scale] : NoiseProgram.GroupArray[GroupIndex].TermArray)
+			{
+				if (TermLayerIndex != LayerIndex)
+				{
+					continue;
+				}
+				
+				TArray<float>& HeightArray { Region.GroupHeightArrays[GroupIndex] };
+
+				ForEachRowChunk(
+					VerticesPerAxis.Y,
+					VerticesPerAxis.X,
+					[&](const int32 RowBegin, const int32 RowEnd)
+					{
+						for (int32 VertexIndex { RowBegin * VerticesPerAxis.X }; VertexIndex < RowEnd * VerticesPerAxis.X; ++VertexIndex)
+						{
+							HeightArray[VertexIndex] += Scale * LayerNoiseArray[VertexIndex];
+						}
+					}
+				);
+			}
+		}
+	}
+}
+
+void ATerrainGenerator::SampleCoarseNoiseLayer(
+	FTerrainSampleRegion& Region, 
+	const int32 LayerIndex, 
+	const int32 LatticeStep
+) const {
+	const FIntPoint VerticesPerAxis { Region.SizeInCells + FIntPoint { 1 } };
+	
+	// The lattice sits on global multiples of the step, so every region interpolates the same points
+	const FIntPoint LatticeOffset {
+		Region.OriginInCells.X - FMath::DivideAndRoundDown(Region.OriginInCells.X, LatticeStep) * LatticeStep,
+		Region.OriginInCells.Y - FMath::DivideAndRoundDown(Region.OriginInCells.Y, LatticeStep) * LatticeStep
+	};
+	
+	const FIntPoint LatticeOriginInCells { Region.OriginInCells - LatticeOffset - FIntPoint { LatticeStep } };
+	
+	// One lattice point of padding before the region and two after, for the cubic stencil
+	const FIntPoint LatticePointsPerAxis { (LatticeOffset + Region.SizeInCells) / LatticeStep + FIntPoint { 4 } };
+	
+	TArray<float>& LayerNoiseArray { Region.LayerNoiseArray };
+	
+	TArray<float>& LatticeArray { Region.LatticeArray };
+	LatticeArray.SetNumUninitialized(LatticePointsPerAxis.X * LatticePointsPerAxis.Y);
+
+	ForEachRowChunk(
+		LatticePointsPerAxis.Y,
+		LatticePointsPerAxis.X,
+		[&](const int32 RowBegin, const int32 RowEnd)
+		{
+			for (int32 Y { RowBegin }; Y < RowEnd; ++Y)
+			{
+				for (int32 X { 0 }; X < LatticePointsPerAxis.X; ++X)
+				{
+					const FVector2f WorldPosition {
+						(LatticeOriginInCells.X + X * LatticeStep) * TerrainConfig->CellSizeInCentimeters,
+						(LatticeOriginInCells.Y + Y * LatticeStep) * TerrainConfig->CellSizeInCentimeters
+					};
+					
+					LatticeArray[Y * LatticePointsPerAxis.X + X] = NoiseProgram.SampleLayer(LayerIndex, WorldPosition);
+				}
+			}
+		}
+	);
+	
+	TArray<float>& RowArray { Region.LatticeRowArray };
+	RowArray.SetNumUninitialized(LatticePointsPerAxis.Y * VerticesPerAxis.X);
+
+	ForEachRowChunk(
+		LatticePointsPerAxis.Y,
+		VerticesPerAxis.X,
+		[&](const int32 RowBegin, const int32 RowEnd)
+		{
+			for (int32 Y { RowBegin }; Y < RowEnd; ++Y)
+			{
+				const float* LatticeRow { &LatticeArray[Y * LatticePointsPerAxis.X] };
+				
+				for (int32 X { 0 }; X < VerticesPerAxis.X; ++X)
+				{
+					const int32 LatticeX { (LatticeOffset.X + X) / LatticeStep + 1 };
+					const float Alpha { static_cast<float>((LatticeOffset.X + X) % LatticeStep) / LatticeStep };
+					
+					RowArray[Y * VerticesPerAxis.X + X] = CubicInterpolate(
+						LatticeRow[LatticeX - 1], 
+						LatticeRow[LatticeX], 
+						LatticeRow[LatticeX + 1], 
+						LatticeRow[LatticeX + 2], 
+						Alpha
+					);
+				}
+			}
+		}
+	);
+
+	ForEachRowChunk(
+		VerticesPerAxis.Y,
+		VerticesPerAxis.X,
+		[&](const int32 RowBegin, const int32 RowEnd)
+		{
+			for (int32 Y { RowBegin }; Y < RowEnd; ++Y)
+			{
+				const int32 LatticeY { (LatticeOffset.Y + Y) / LatticeStep + 1 };
+				const float Alpha { static_cast<float>((LatticeOffset.Y + Y) % LatticeStep) / LatticeStep };
+				
+				for (int32 X { 0 }; X < VerticesPerAxis.X; ++X)
+				{
+					LayerNoiseArray[Region.GetVertexIndex({ X, Y })] = CubicInterpolate(
+						RowArray[(LatticeY - 1) * VerticesPerAxis.X + X],
+						RowArray[LatticeY * VerticesPerAxis.X + X],
+						RowArray[(LatticeY + 1) * VerticesPerAxis.X + X],
+						RowArray[(LatticeY + 2) * VerticesPerAxis.X + X],
+						Alpha
+					);
+				}
+			}
+		}
+	);
+}
+
+float ATerrainGenerator::CubicInterpolate(const float P0, const float P1, const float P2, const float P3, const float Alpha)
+{
+	// Catmull-Rom, exact at the lattice points
+	return P1 + 0.5f * Alpha * (
+		P2 - P0 + Alpha * (
+			2.0f * P0 - 5.0f * P1 + 4.0f * P2 - P3 + Alpha * (
+				3.0f * (P1 - P2) + P3 - P0
+			)
+		)
+	);
+}
+
+void ATerrainGenerator::UpdateVisibleSectors(const FStreamingTargets& NewStreamingTargets)
+{
+	const TSet<FIntPoint> NewStreamingSectorCoordinatesSet { ComputeStreamingSet(NewStreamingTargets) };
+	
+	const TSet<FIntPoint> MissingSectorCoordinatesSet { NewStreamingSectorCoordinatesSet.Difference(StreamingSectorCoordinatesSet) };
+	const TSet<FIntPoint> ExpiredSectorCoordinatesSet { StreamingSectorCoordinatesSet.Difference(NewStreamingSectorCoordinatesSet) };
+	
+	StreamingTargets = NewStreamingTargets;
+	StreamingSectorCoordinatesSet = NewStreamingSectorCoordinatesSet;
+
+	RemoveExpiredSectors(ExpiredSectorCoordinatesSet);
+	UpdateGenerationPriorities();
+	AddMissingSectors(MissingSectorCoordinatesSet);
+	DispatchSectorGeneration();
+}
+
+TSet<FIntPoint> ATerrainGenerator::ComputeStreamingSet(const FStreamingTargets& Targets) const
+{
+	TSet<FIntPoint> StreamingSet { ComputeVisibleSet(Targets.PlayerSectorCoordinates, TerrainConfig) };
+
+	auto AddPrefetchPath = [&](const FIntPoint& TargetSectorCoordinates)
+	{
+		const FIntPoint Offset { TargetSectorCoordinates - Targets.PlayerSectorCoordinates };
+		const int32 StepNum { FMath::Max(FMath::Abs(Offset.X), FMath::Abs(Offset.Y)) };
+
+		for (int32 Step { 1 }; Step <= StepNum; ++Step)
+		{
+			const float Alpha { static_cast<float>(Step) / StepNum };
+			
+			const FIntPoint PathSectorCoordinates {
+				Targets.PlayerSectorCoordinates.X + FMath::RoundToInt(Offset.X * Alpha),
+				Targets.PlayerSectorCoordinates.Y + FMath::RoundToInt(Offset.Y * Alpha)
+			};
+			
+			StreamingSet.Append(ComputeVisibleSet(PathSectorCoordinates, TerrainConfig));
+		}
+	};
+
+	AddPrefetchPath(Targets.HeadingSectorCoordinates);
+	AddPrefetchPath(Targets.ViewSectorCoordinates);
+
+	return StreamingSet;
+}
+
+FIntPoint ATerrainGenerator::GetSectorCoordinates(const FVector& Location) const
+{
+	const FIntPoint SectorPosition {
+		FMath::FloorToInt(Location.X / TerrainConfig->GetSectorSizeInCentimeters()),
+		FMath::FloorToInt(Location.Y / TerrainConfig->GetSectorSizeInCentimeters())
+	};
+
+	return SectorPosition;
+}
+
+TSet<FIntPoint> ATerrainGenerator::ComputeVisibleSet(const FIntPoint& PlayerSector, const TObjectPtr<UTerrainConfig> TerrainConfig)
+{
+	TSet<FIntPoint> VisibleSectorCoordinates;
+
+	for (int X { -ViewRadius }; X <= ViewRadius; ++X)
+	{
+		for (int Y { -ViewRadius }; Y <= ViewRadius; ++Y)
+		{
+			if (
+				const FIntPoint SectorCoordinates { PlayerSector + FIntPoint(X, Y) };
+				SectorCoordinates.X >= 0 &&
+				SectorCoordinates.Y >= 0 &&
+				SectorCoordinates.X < TerrainConfig->WorldSizeInSectors &&
+				SectorCoordinates.Y < TerrainConfig->WorldSizeInSectors
+			) {
+				VisibleSectorCoordinates.Add(SectorCoordinates);
+			}
+		}
+	}
+
+	return VisibleSectorCoordinates;
+}
+
+void ATerrainGenerator::AddMissingSectors(const TSet<FIntPoint>& MissingSectorCoordinatesSet)
+{
+	for (const FIntPoint& SectorCoordinates : MissingSectorCoordinatesSet)
+	{
+		FSectorSlot& Slot { ClaimSectorSlot(SectorCoordinates) };
+		
+		if (Slot.SectorComponent || Slot.Request || Slot.bBuildingMeshes)
+		{
+			continue;
+		}
+		
+		if (Slot.bHasRenderData)
+		{
+			CommitQueue.AddUnique(SectorCoordinates);
+		}
+		else
+		{
+			RequestSectorGeneration(Slot);
+		}
+	}
+	
+	SetActorTickEnabled(!CommitQueue.IsEmpty() || PendingRequestNum > 0);
+}
+
+void ATerrainGenerator::RequestSectorGeneration(FSectorSlot& Slot)
+{
+	const TSharedRef<FSectorGenerationRequest> Request { MakeShared<FSectorGenerationRequest>() };
+	Request->SectorCoordinates = Slot.SectorCoordinates;
+	Request->Priority = GetGenerationPriority(Slot.SectorCoordinates);
+	Request->SectorRenderData = MoveTemp(Slot.SectorRenderData);
+	
+	if (Request->SectorRenderData.GroundMeshRenderData.VertexArray.Max() == 0 && !SpareRenderDataArray.IsEmpty())
+	{
+		Request->SectorRenderData = SpareRenderDataArray.Pop(EAllowShrinking::No);
+	}
+	
+	Request->SectorRenderData.Reserve(TerrainConfig->GetSectorCellNum());
+	
+	Slot.Request = Request;
+	
+	++PendingRequestNum;
+	
+	QueuedRequestArray.Add(Request);
+}
+
+int32 ATerrainGenerator::GetGenerationPriority(const FIntPoint SectorCoordinates) const
+{
+	if (!StreamingTargets.IsSet())
+	{
+		return 0;
+	}
+	
+	return (SectorCoordinates - StreamingTargets->PlayerSectorCoordinates).SizeSquared();
+}
+
+void ATerrainGenerator::UpdateGenerationPriorities()
+{
+	for (const TSharedRef<FSectorGenerationRequest>& Request : QueuedRequestArray)
+	{
+		Request->Priority = GetGenerationPriority(Request->SectorCoordinates);
+	}
+}
+
+void ATerrainGenerator::CancelSectorGeneration(FSectorSlot& Slot)
+{
+	if (!Slot.Request)
+	{
+		return;
+	}
+
+	const TSharedRef<FSectorGenerationRequest> Request { Slot.Request.ToSharedRef() };
+	
+	Slot.Request.Reset();
+	
+	--PendingRequestNum;
+
+	Request->bCancelled = true;
+
+	// A running request is dropped when its batch reports back
+	if (!Request->bRunning)
+	{
+		QueuedRequestArray.RemoveSingle(Request);
+		
+		Slot.SectorRenderData = MoveTemp(Request->SectorRenderData);
+	}
+}
+
+void ATerrainGenerator::DispatchSectorGeneration()
+{
+	GenerationTaskArray.RemoveAll(
+		[](const UE::Tasks::FTask& Task)
+		{
+			return Task.IsCompleted();
+		}
+	);
+	
+	if (QueuedRequestArray.IsEmpty() || GenerationTaskArray.Num() >= MaxRunningGenerationNum)
+	{
+		return;
+	}
+
+	// Highest priority last so it pops first
+	QueuedRequestArray.Sort(
+		[](const TSharedRef<FSectorGenerationRequest>& A, const TSharedRef<FSectorGenerationRequest>& B)
+		{
+			return A->Priority > B->Priority;
+		}
+	);
+
+	while (!QueuedRequestArray.IsEmpty() && GenerationTaskArray.Num() < MaxRunningGenerationNum)
+	{
+		TArray<TSharedRef<FSectorGenerationRequest>> BatchRequestArray;
+		
+		const FIntRect BatchRect { GatherGenerationBatch(QueuedRequestArray.Last()->SectorCoordinates, BatchRequestArray) };
+		
+		for (const TSharedRef<FSectorGenerationRequest>& Request : BatchRequestArray)
+		{
+			Request->bRunning = true;
+			
+			QueuedRequestArray.RemoveSingle(Request);
+		}
+		
+		GenerationTaskArray.Add(
+			UE::Tasks::Launch(
+				UE_SOURCE_LOCATION,
+				[this, BatchRect, BatchRequestArray = MoveTemp(BatchRequestArray)]
+				{
+					GenerateSectorBatchRenderData(BatchRect, BatchRequestArray);
+					
+					for (const TSharedRef<FSectorGenerationRequest>& Request : BatchRequestArray)
+					{
+						GeneratedRequestQueue.Enqueue(Request);
+					}
+				}
+			)
+		);
+	}
+}
+
+FIntRect ATerrainGenerator::GatherGenerationBatch(
+	const FIntPoint LeadSectorCoordinates, 
+	TArray<TSharedRef<FSectorGenerationRequest>>& BatchRequestArray
+) {
+	auto IsQueued = [this](const FIntPoint& SectorCoordinates)
+	{
+		const FSectorSlot* Slot { SectorGrid.Find(SectorCoordinates) };
+		
+		return Slot && Slot->Request && !Slot->Request->bRunning;
+	};
+	
+	// Inclusive bounds in sector coordinates, grown while every sector on the new edge is queued
+	FIntRect BatchRect { LeadSectorCoordinates, LeadSectorCoordinates };
+
+	const FIntPoint DirectionArray[] { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+	
+	bool bGrown { true };
+
+	while (bGrown)
+	{
+		bGrown = false;
+		
+		for (const FIntPoint& Direction : DirectionArray)
+		{
+			FIntRect GrownRect { BatchRect };
+			
+			GrownRect.Min += FIntPoint { FMath::Min(Direction.X, 0), FMath::Min(Direction.Y, 0) };
+			GrownRect.Max += FIntPoint { FMath::Max(Direction.X, 0), FMath::Max(Direction.Y, 0) };
+			
+			if ((GrownRect.Width() + 1) * (GrownRect.Height() + 1) > MaxGenerationBatchSectorNum)
+			{
+				continue;
+			}
+			
+			const FIntPoint EdgeMin { Direction.X > 0 ? GrownRect.Max.X : GrownRect.Min.X, Direction.Y > 0 ? GrownRect.Max.Y : GrownRect.Min.Y };
+			const FIntPoint EdgeMax { Direction.X < 0 ? GrownRect.Min.X : GrownRect.Max.X, Direction.Y < 0 ? GrownRect.Min.Y : GrownRect.Max.Y };
+			
+			bool bEdgeQueued { true };
+			
+			for (int32 Y { EdgeMin.Y }; Y <= EdgeMax.Y && bEdgeQueued; ++Y)
+			{
+				for (int32 X { EdgeMin.X }; X <= EdgeMax.X && bEdgeQueued; ++X)
+				{
+					bEdgeQueued = IsQueued({ X, Y });
+				}
+			}
+			
+			if (bEdgeQueued)
+			{
+				BatchRect = GrownRect;
+				bGrown = true;
+			}
+		}
+	}
+	
+	for (int32 Y { BatchRect.Min.Y }; Y <= BatchRect.Max.Y; ++Y)
+	{
+		for (int32 X { BatchRect.Min.X }; X <= BatchRect.Max.X; ++X)
+		{
+			BatchRequestArray.Add(SectorGrid.Find({ X, Y })->Request.ToSharedRef());
+		}
+	}
+	
+	return BatchRect;
+}
+
+void ATerrainGenerator::GenerateSectorBatchRenderData(
+	const FIntRect& BatchRect, 
+	const TArray<TSharedRef<FSectorGenerationRequest>>& BatchRequestArray
+) const {
+	auto IsCancelled = [&BatchRequestArray]
+	{
+		return Algo::AllOf(
+			BatchRequestArray, 
+			[](const TSharedRef<FSectorGenerationRequest>& Request)
+			{
+				return Request->bCancelled.load(std::memory_order_relaxed);
+			}
+		);
+	};
+	
+	TUniquePtr<FTerrainSampleRegion> Region { SampleRegionPool.Acquire() };
+	
+	// Adjacent sectors share one contiguous region, so their common borders are sampled once
+	const bool bSampled {
+		SampleRegion(
+			BatchRect.Min * TerrainConfig->SectorSizeInCells,
+			(BatchRect.Max - BatchRect.Min + FIntPoint { 1 }) * TerrainConfig->SectorSizeInCells,
+			*Region,
+			IsCancelled
+		)
+	};
+	
+	if (bSampled)
+	{
+		for (const TSharedRef<FSectorGenerationRequest>& Request : BatchRequestArray)
+		{
+			if (!Request->bCancelled.load(std::memory_order_relaxed))
+			{
+				BuildSectorRenderData(*Region, Request->SectorCoordinates, Request->SectorRenderData);
+				
+				Request->bSucceeded = true;
+			}
+		}
+	}
+	
+	SampleRegionPool.Release(MoveTemp(Region));
+}
+
+void ATerrainGenerator::ReceiveGeneratedSectors()
+{
+	TSharedPtr<FSectorGenerationRequest> Request;
+	
+	while (GeneratedRequestQueue.Dequeue(Request))
+	{
+		if (Request->bCancelled)
+		{
+			SpareRenderDataArray.Add(MoveTemp(Request->SectorRenderData));
+			
+			continue;
+		}
+		
+		const FIntPoint SectorCoordinates { Request->SectorCoordinates };
+		
+		FSectorSlot* Slot { SectorGrid.Find(SectorCoordinates) };
+		
+		if (!Slot || Slot->Request != Request)
+		{
+			continue;
+		}
+		
+		Slot->Request.Reset();
+		
+		--PendingRequestNum;
+		
+		// A sector that failed to sample keeps no render data, and its buffers go back to the spares
+		if (!Request->bSucceeded)
+		{
+			SpareRenderDataArray.Add(MoveTemp(Request->SectorRenderData));
+			
+			continue;
+		}
+		
+		Slot->SectorRenderData = MoveTemp(Request->SectorRenderData);
+		Slot->bHasRenderData = true;
+		
+		if (Slot->SectorComponent)
+		{
+			// A regenerated sector replaces its meshes on the component it already has, within the commit budget
+			ReleaseSectorMeshes(*Slot);
+			
+			Slot->bMeshesOutdated = true;
+		}
+		
+		if (StreamingSectorCoordinatesSet.Contains(SectorCoordinates))
+		{
+			CommitQueue.AddUnique(SectorCoordinates);
+		}
+	}
+	
+	GenerationTaskArray.RemoveAll(
+		[](const UE::Tasks::FTask& Task)
+		{
+			return Task.IsCompleted();
+		}
+	);
+}
+
+void ATerrainGenerator::CommitSectors()
+{
+	SCOPE_CYCLE_COUNTER(STAT_CommitSectors);
+	
+	if (CommitQueue.IsEmpty())
+	{
+		return;
+	}
+	
+#if WITH_EDITOR
+	if (bBuildFromMeshDescription && SectorMeshBackend == ESectorMeshBackend::StaticMesh)
+	{
+		CommitSectorBatch();
+		
+		return;
+	}
+#endif
+	
+	const FIntPoint PlayerSectorCoordinates { 
+		StreamingTargets.IsSet() ? StreamingTargets->PlayerSectorCoordinates : FIntPoint::ZeroValue 
+	};
+
+	// Nearest sectors last so they pop first
+	CommitQueue.Sort(
+		[&](const FIntPoint& A, const FIntPoint& B)
+		{
+			return (A - PlayerSectorCoordinates).SizeSquared() > (B - PlayerSectorCoordinates).SizeSquared();
+		}
+	);
+	
+	const double StartTime { FPlatformTime::Seconds() };
+	const double BudgetSeconds { CommitBudgetMilliseconds / 1000.0 };
+
+	// At least one sector is committed per frame so a tight budget still makes progress
+	do
+	{
+		const FIntPoint SectorCoordinates { CommitQueue.Pop(EAllowShrinking::No) };
+		
+		if (
+			FSectorSlot* Slot { SectorGrid.Find(SectorCoordinates) };
+			Slot && 
+			Slot->bHasRenderData && 
+			(!Slot->SectorComponent || Slot->bMeshesOutdated) && 
+			StreamingSectorCoordinatesSet.Contains(SectorCoordinates)
+		) {
+			CommitSector(*Slot);
+		}
+	}
+	while (!CommitQueue.IsEmpty() && FPlatformTime::Seconds() - StartTime < BudgetSeconds);
+}
+
+#if WITH_EDITOR
+void ATerrainGenerator::CommitSectorBatch()
+{
+	TArray<const FSectorRenderData*> BuildRenderDataArray;
+	TMap<FIntPoint, uint32> MeshBuildIdMap;
+	
+	for (const FIntPoint& SectorCoordinates : CommitQueue)
+	{
+		FSectorSlot* Slot { SectorGrid.Find(SectorCoordinates) };
+		
+		if (
+			!Slot || 
+			!Slot->bHasRenderData || 
+			Slot->bBuildingMeshes || 
+			(Slot->SectorComponent && !Slot->bMeshesOutdated) || 
+			!StreamingSectorCoordinatesSet.Contains(SectorCoordinates)
+		) {
+			continue;
+		}
+		
+		if (Slot->SectorMeshes.GroundStaticMesh)
+		{
+			CommitSector(*Slot);
+		}
+		else
+		{
+			Slot->bBuildingMeshes = true;
+			Slot->MeshBuildId++;
+			
+			BuildRenderDataArray.Add(&Slot->SectorRenderData);
+			MeshBuildIdMap.Add(SectorCoordinates, Slot->MeshBuildId);
+		}
+	}
+	
+	CommitQueue.Reset();
+	
+	if (BuildRenderDataArray.IsEmpty())
+	{
+		return;
+	}
+	
+	FStaticMeshConstructor::RunBatchFromMeshDescription(
+		this,
+		BuildRenderDataArray,
+		[this, MeshBuildIdMap = MoveTemp(MeshBuildIdMap)](const FIntPoint SectorCoordinates, const FSectorMeshes& SectorMeshes)
+		{
+			OnSectorMeshesBuilt(SectorCoordinates, MeshBuildIdMap.FindChecked(SectorCoordinates), SectorMeshes);
+		}
+	);
+}
+
+void ATerrainGenerator::OnSectorMeshesBuilt(
+	const FIntPoint SectorCoordinates, 
+	const uint32 MeshBuildId, 
+	const FSectorMeshes& SectorMeshes
+) {
+	FSectorSlot* Slot { SectorGrid.Find(SectorCoordinates) };
+	
+	// The slot was released, reclaimed or edited since this build started
+	if (!Slot || !Slot->bBuildingMeshes || Slot->MeshBuildId != MeshBuildId)
+	{
+		for (UStaticMesh* StaticMesh : { SectorMeshes.GroundStaticMesh.Get(), SectorMeshes.WaterStaticMesh.Get() })
+		{
+			if (StaticMesh)
+			{
+				StaticMesh->ClearFlags(RF_Standalone);
+			}
+		}
+		
+		return;
+	}
+	
+	Slot->bBuildingMeshes = false;
+	Slot->SectorMeshes = SectorMeshes;
+	
+	if ((!Slot->SectorComponent || Slot->bMeshesOutdated) && StreamingSectorCoordinatesSet.Contains(SectorCoordinates))
+	{
+		CommitSector(*Slot);
+	}
+}
+#endif
+
+void ATerrainGenerator::CommitSector(FSectorSlot& Slot)
+{
+	Slot.bMeshesOutdated = false;
+	
+	const bool bNewComponent { !Slot.SectorComponent };
+	
+	GenerateSector(Slot);
+	
+	if (SectorMeshBackend == ESectorMeshBackend::DynamicMesh)
+	{
+		CommitSectorDynamicMeshes(Slot);
+	}
+	else
+	{
+		CommitSectorStaticMeshes(Slot);
+	}
+	
+	CommitSectorScatter(Slot);
+	
+	if (bNewComponent)
+	{
+		UpdateHorizon(Slot.SectorCoordinates, 1);
+	}
+}
+
+void ATerrainGenerator::CommitSectorStaticMeshes(FSectorSlot& Slot)
+{
+	const FIntPoint SectorCoordinates { Slot.SectorCoordinates };
+	
+	const TObjectPtr<USectorComponent> SectorComponent { Slot.SectorComponent };
+	
+	if (!Slot.SectorMeshes.GroundStaticMesh)
+	{
+		const FSectorRenderData& SectorRenderData { Slot.SectorRenderData };
+		
+		auto BuildStaticMesh = [this](const FString& MeshName, const FMeshRenderData& MeshRenderData, const bool bGenerateCollision)
+		{
+#if WITH_EDITOR
+			if (bBuildFromMeshDescription)
+			{
+				return FStaticMeshConstructor::RunFromMeshDescription(this, *MeshName, MeshRenderData, bGenerateCollision);
+			}
+#endif
+			return FStaticMeshConstructor::Run(this, *MeshName, MeshRenderData, bGenerateCollision);
+		};
+		
+		Slot.SectorMeshes = FSectorMeshes {
+			BuildStaticMesh(
+				FString::Printf(TEXT("SMG_%d_%d"), SectorCoordinates.X, SectorCoordinates.Y),
+				SectorRenderData.GetGroundMeshRenderData(),
+				true
+			),
+			BuildStaticMesh(
+				FString::Printf(TEXT("SMW_%d_%d"), SectorCoordinates.X, SectorCoordinates.Y),
+				SectorRenderData.WaterMeshRenderData,
+				false
+			)
+		};
+	}
+	
+	const auto& [GroundStaticMesh, WaterStaticMesh] { Slot.SectorMeshes };
+	
+	SectorComponent->GroundStaticMeshComponent->SetStaticMesh(GroundStaticMesh.Get());
+	SectorComponent->WaterStaticMeshComponent->SetStaticMesh(WaterStaticMesh.Get());
+	
+	SetupSectorMaterials(SectorComponent->GroundStaticMeshComponent, SectorComponent->WaterStaticMeshComponent);
+}
+
+void ATerrainGenerator::CommitSectorDynamicMeshes(FSectorSlot& Slot)
+{
+	const TObjectPtr<USectorComponent> SectorComponent { Slot.SectorComponent };
+	
+	SectorComponent->SetupDynamicMeshComponents();
+	
+	FDynamicMeshConstructor::Run(
+		SectorComponent->GroundDynamicMeshComponent, 
+		Slot.SectorRenderData.GetGroundMeshRenderData(), 
+		true
+	);
+	
+	FDynamicMeshConstructor::Run(
+		SectorComponent->WaterDynamicMeshComponent, 
+		Slot.SectorRenderData.WaterMeshRenderData, 
+		false
+	);
+	
+	SetupSectorMaterials(SectorComponent->GroundDynamicMeshComponent, SectorComponent->WaterDynamicMeshComponent);
+}
+
+void ATerrainGenerator::SetupSectorMaterials(UMeshComponent* GroundMeshComponent, UMeshComponent* WaterMeshComponent) const
+{
+	GroundMeshComponent->SetRelativeLocation(FVector::ZeroVector);
+	GroundMeshComponent->SetMaterial(0, TerrainMaterial.Get());
+	GroundMeshComponent->MarkRenderStateDirty();
+	
+	UMaterialInstanceDynamic* TerrainMaterialInstance 
+	{ 
+		GroundMeshComponent->CreateDynamicMaterialInstance(0) 
+	};
+	
+	TerrainMaterialInstance->SetScalarParameterValue(TEXT("BiomeIndexMax"), BiomeSet->BiomeDefinitionArray.Num() - 1);
+	
+	WaterMeshComponent->SetRelativeLocation(FVector::ZeroVector);
+	WaterMeshComponent->SetMaterial(0, WaterMaterial.Get());
+	WaterMeshComponent->SetTranslucentSortPriority(1);
+	WaterMeshComponent->SetCastShadow(false);
+	WaterMeshComponent->SetReceivesDecals(false);
+	WaterMeshComponent->MarkRenderStateDirty();
+}
+
+void ATerrainGenerator::CommitSectorScatter(FSectorSlot& Slot)
+{
+	const TArray<TArray<FTransform>>& RuleTransformArrays { Slot.SectorRenderData.ScatterData.RuleTransformArrays };
+	
+	Slot.ScatterComponentArray.SetNum(ScatterRuleArray.Num());
+	
+	for (int32 RuleIndex { 0 }; RuleIndex < ScatterRuleArray.Num(); ++RuleIndex)
+	{
+		TObjectPtr<UHierarchicalInstancedStaticMeshComponent>& ScatterComponent { Slot.ScatterComponentArray[RuleIndex] };
+		
+		if (ScatterComponent)
+		{
+			ScatterComponent->ClearInstances();
+		}
+		
+		if (!RuleTransformArrays.IsValidIndex(RuleIndex) || RuleTransformArrays[RuleIndex].IsEmpty())
+		{
+			continue;
+		}
+		
+		if (!ScatterComponent)
+		{
+			const auto& [BiomeIndex, BiomeRuleIndex] { ScatterRuleArray[RuleIndex] };
+			
+			const FScatterRule& ScatterRule { BiomeSet->BiomeDefinitionArray[BiomeIndex].ScatterRuleArray[BiomeRuleIndex] };
+			
+			ScatterComponent = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+			ScatterComponent->SetMobility(EComponentMobility::Movable);
+			ScatterComponent->SetStaticMesh(ScatterRule.Mesh);
+			ScatterComponent->SetCullDistances(0, FMath::RoundToInt(ScatterRule.CullDistance));
+			ScatterComponent->SetCollisionEnabled(
+				ScatterRule.bGenerateCollision ? ECollisionEnabled::QueryAndPhysics : ECollisionEnabled::NoCollision
+			);
+			ScatterComponent->RegisterComponent();
+		}
+		
+		ScatterComponent->AttachToComponent(Slot.SectorComponent, FAttachmentTransformRules::KeepRelativeTransform);
+		ScatterComponent->SetRelativeTransform(FTransform::Identity);
+		ScatterComponent->AddInstances(RuleTransformArrays[RuleIndex], false, false);
+	}
+}
+
+void ATerrainGenerator::ReleaseSectorScatter(FSectorSlot& Slot)
+{
+	// Components stay registered with the slot so the next sector only refills their instances
+	for (UHierarchicalInstancedStaticMeshComponent* ScatterComponent : Slot.ScatterComponentArray)
+	{
+		if (ScatterComponent)
+		{
+			ScatterComponent->ClearInstances();
+			ScatterComponent->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
+		}
+	}
+}
+
+void ATerrainGenerator::UpdateSectorMesh(const FIntPoint SectorCoordinates, const FIntRect& CellRect)
+{
+	FSectorSlot* Slot { SectorGrid.Find(SectorCoordinates) };
+	
+	if (!Slot || !Slot->bHasRenderData)
+	{
+		return;
+	}
+	
+	if (Slot->SectorRenderData.VoxelData.bVolumetric)
+	{
+		// Contoured meshes have no fixed vertex per cell, and sectors after this one contour its last column in their apron
+		RegenerateSectors(FIntRect { SectorCoordinates, SectorCoordinates + FIntPoint { 1 } });
+		
+		return;
+	}
+	
+	// Height-field sectors can still border volumetric ones, which contour this sector's last column in their apron
+	for (const FIntPoint Offset : { FIntPoint { 1, 0 }, FIntPoint { 0, 1 }, FIntPoint { 1, 1 } })
+	{
+		if (
+			const FSectorSlot* NeighborSlot { SectorGrid.Find(SectorCoordinates + Offset) }; 
+			NeighborSlot && NeighborSlot->SectorRenderData.VoxelData.bVolumetric
+		) {
+			RegenerateSectors(FIntRect { SectorCoordinates + Offset, SectorCoordinates + Offset });
+		}
+	}
+	
+	const USectorComponent* SectorComponent { Slot->SectorComponent };
+	
+	if (!SectorComponent)
+	{
+		// Uncommitted sectors pick up the edited render data when they are committed
+		ReleaseSectorMeshes(*Slot);
+		
+		if (Slot->bBuildingMeshes)
+		{
+			Slot->bBuildingMeshes = false;
+			
+			CommitQueue.AddUnique(SectorCoordinates);
+			SetActorTickEnabled(true);
+		}
+		
+		return;
+	}
+	
+	if (SectorMeshBackend == ESectorMeshBackend::StaticMesh || !SectorComponent->GroundDynamicMeshComponent)
+	{
+		// Static meshes have no partial update, the sector's meshes are rebuilt on the existing component
+		ReleaseSectorMeshes(*Slot);
+		CommitSector(*Slot);
+		
+		return;
+	}
+	
+	const int32 SectorSize { TerrainConfig->SectorSizeInCells };
+	
+	const FIntRect ClippedCellRect { 
+		CellRect.Min.ComponentMax(FIntPoint::ZeroValue), 
+		CellRect.Max.ComponentMin(FIntPoint { SectorSize }) 
+	};
+	
+	if (ClippedCellRect.IsEmpty())
+	{
+		return;
+	}
+	
+	TArray<int32> VertexIndexArray;
+	VertexIndexArray.Reserve(4 * ClippedCellRect.Area());
+	
+	for (int32 Y { ClippedCellRect.Min.Y }; Y < ClippedCellRect.Max.Y; ++Y)
+	{
+		for (int32 X { ClippedCellRect.Min.X }; X < ClippedCellRect.Max.X; ++X)
+		{
+			const int32 IndexBase { 4 * (Y * SectorSize + X) };
+			
+			VertexIndexArray.Append({ IndexBase + 0, IndexBase + 1, IndexBase + 2, IndexBase + 3 });
+		}
+	}
+	
+	// Brushes only edit terrain heights, so the water mesh is left untouched
+	FDynamicMeshConstructor::UpdateVertices(
+		SectorComponent->GroundDynamicMeshComponent, 
+		Slot->SectorRenderData.GroundMeshRenderData, 
+		VertexIndexArray
+	);
+}
+
+void ATerrainGenerator::ReleaseSectorMeshes(FSectorSlot& Slot)
+{
+	// Sector meshes are created standalone, so they only become collectable once the flag is cleared
+	for (UStaticMesh* StaticMesh : { Slot.SectorMeshes.GroundStaticMesh.Get(), Slot.SectorMeshes.WaterStaticMesh.Get() })
+	{
+		if (StaticMesh)
+		{
+			StaticMesh->ClearFlags(RF_Standalone);
+		}
+	}
+	
+	Slot.SectorMeshes = FSectorMeshes {};
+}
+
+void ATerrainGenerator::ApplyTerrainBrush(const FVector& WorldLocation, const FTerrainBrush& Brush)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ApplyTerrainBrush);
+	
+	if (!TerrainConfig || Brush.Radius <= 0.0f)
+	{
+		return;
+	}
+	
+	const float CellSize { TerrainConfig->CellSizeInCentimeters };
+	const int32 WorldSizeInCells { TerrainConfig->WorldSizeInSectors * TerrainConfig->SectorSizeInCells };
+	
+	// Grid vertices inside the brush circle's bounds, Max exclusive
+	const FIntRect VertexRect {
+		FIntPoint { 
+			FMath::CeilToInt((WorldLocation.X - Brush.Radius) / CellSize), 
+			FMath::CeilToInt((WorldLocation.Y - Brush.Radius) / CellSize) 
+		}.ComponentMax(FIntPoint::ZeroValue),
+		FIntPoint { 
+			FMath::FloorToInt((WorldLocation.X + Brush.Radius) / CellSize) + 1, 
+			FMath::FloorToInt((WorldLocation.Y + Brush.Radius) / CellSize) + 1 
+		}.ComponentMin(FIntPoint { WorldSizeInCells + 1 })
+	};
+	
+	if (VertexRect.IsEmpty())
+	{
+		return;
+	}
+	
+	// Heights are read before any are written, with a one vertex border for the smoothing stencil
+	const FIntRect SampleRect { VertexRect.Min - FIntPoint { 1 }, VertexRect.Max + FIntPoint { 1 } };
+	const int32 SampleWidth { SampleRect.Width() };
+	
+	BrushHeightArray.Reset();
+	
+	for (int32 Y { SampleRect.Min.Y }; Y < SampleRect.Max.Y; ++Y)
+	{
+		for (int32 X { SampleRect.Min.X }; X < SampleRect.Max.X; ++X)
+		{
+			BrushHeightArray.Add(FindVertexHeight({ X, Y }));
+		}
+	}
+	
+	auto GetSampledHeight = [&](const int32 X, const int32 Y) -> const TOptional<float>&
 	{
-		if (!VisibleSectorCoordinatesSet.Contains(Iterator.Key()))
+		return BrushHeightArray[(Y - SampleRect.Min.Y) * SampleWidth + X - SampleRect.Min.X];
+	};
+	
+	BrushHeightDeltaArray.Reset();
+	
+	for (int32 Y { VertexRect.Min.Y }; Y < VertexRect.Max.Y; ++Y)
+	{
+		for (int32 X { VertexRect.Min.X }; X < VertexRect.Max.X; ++X)
 		{
-			USectorComponent* SectorComponent { Iterator.Value() };
+			const TOptional<float>& Height { GetSampledHeight(X, Y) };
 			
-			if (SectorComponent->GroundStaticMeshComponent)
+			const float Distance { 
+				FVector2f { X * CellSize - static_cast<float>(WorldLocation.X), Y * CellSize - static_cast<float>(WorldLocation.Y) }.Size() 
+			};
+			
+			if (!Height.IsSet() || Distance >= Brush.Radius)
 			{
-				SectorComponent->GroundStaticMeshComponent->DestroyComponent();
+				continue;
 			}
 			
-			if (SectorComponent->WaterStaticMeshComponent)
+			const float Weight { FMath::Square(1.0f - FMath::Square(Distance / Brush.Radius)) };
+			const float Alpha { FMath::Clamp(Brush.Strength * Weight, 0.0f, 1.0f) };
+			
+			float NewHeight { Height.GetValue() };
+			
+			switch (Brush.Mode)
 			{
-				SectorComponent->WaterStaticMeshComponent->DestroyComponent();
+			case ETerrainBrushMode::Raise:
+				NewHeight += Brush.Strength * Weight;
+				break;
+				
+			case ETerrainBrushMode::Lower:
+				NewHeight -= Brush.Strength * Weight;
+				break;
+				
+			case ETerrainBrushMode::Flatten:
+				NewHeight = FMath::Lerp(NewHeight, static_cast<float>(WorldLocation.Z), Alpha);
+				break;
+				
+			case ETerrainBrushMode::Smooth:
+				{
+					float NeighborHeightSum { 0.0f };
+					int32 NeighborNum { 0 };
+					
+					for (const FIntPoint& Offset : { FIntPoint { 1, 0 }, FIntPoint { -1, 0 }, FIntPoint { 0, 1 }, FIntPoint { 0, -1 } })
+					{
+						if (const TOptional<float>& NeighborHeight { GetSampledHeight(X + Offset.X, Y + Offset.Y) })
+						{
+							NeighborHeightSum += NeighborHeight.GetValue();
+							++NeighborNum;
+						}
+					}
+					
+					if (NeighborNum > 0)
+					{
+						NewHeight = FMath::Lerp(NewHeight, NeighborHeightSum / NeighborNum, Alpha);
+					}
+				}
+				break;
 			}
 			
-			SectorComponent->DestroyComponent();
-			
-			Iterator.RemoveCurrent();
+			if (!FMath::IsNearlyEqual(NewHeight, Height.GetValue()))
+			{
+				BrushHeightDeltaArray.Emplace(FIntPoint { X, Y }, NewHeight - Height.GetValue());
+			}
 		}
 	}
+	
+	if (BrushHeightDeltaArray.IsEmpty())
+	{
+		return;
+	}
+	
+	TerrainEditLayer.AddHeightDeltas(BrushHeightDeltaArray);
+	
+	// Dirty cells per touched sector, Max exclusive
+	TArray<TPair<FIntPoint, FIntRect>, TInlineAllocator<4>> DirtyRectArray;
+	
+	for (const auto& [VertexCoordinates, HeightDelta] : BrushHeightDeltaArray)
+	{
+		ForEachVertexCorner(
+			VertexCoordinates,
+			[&](FSectorSlot& Slot, const FIntPoint CellCoordinates, const int32 VertexIndex)
+			{
+				Slot.SectorRenderData.GroundMeshRenderData.VertexArray[VertexIndex].Z += HeightDelta;
+				
+				TPair<FIntPoint, FIntRect>* DirtyRect { 
+					DirtyRectArray.FindByPredicate(
+						[&Slot](const TPair<FIntPoint, FIntRect>& Pair) 
+						{ 
+							return Pair.Key == Slot.SectorCoordinates; 
+						}
+					) 
+				};
+				
+				if (!DirtyRect)
+				{
+					DirtyRect = &DirtyRectArray.Emplace_GetRef(Slot.SectorCoordinates, FIntRect { CellCoordinates, CellCoordinates });
+				}
+				
+				DirtyRect->Value.Min = DirtyRect->Value.Min.ComponentMin(CellCoordinates);
+				DirtyRect->Value.Max = DirtyRect->Value.Max.ComponentMax(CellCoordinates + FIntPoint { 1 });
+			}
+		);
+	}
+	
+	RestartRunningGeneration(VertexRect);
+	
+	for (const auto& [SectorCoordinates, CellRect] : DirtyRectArray)
+	{
+		UpdateSectorMesh(SectorCoordinates, CellRect);
+	}
 }
 
-int32 ATerrainGenerator::GetRegionID(const FVector2f& WorldPosition) const
+float ATerrainGenerator::BenchmarkTerrainBrush(const FTerrainBrush& Brush, const int32 EditNum)
 {
-	constexpr int32 RegionBucketCount { 1'000'000 };
+	const APawn* PlayerPawn { UGameplayStatics::GetPlayerPawn(GetWorld(), 0) };
+	
+	if (!PlayerPawn || !TerrainConfig || EditNum <= 0)
+	{
+		return 0.0f;
+	}
 	
-	const float RegionLabel { BiomeNoise.GetNoise(WorldPosition.X, WorldPosition.Y) };
-	const float RegionLabelNormalized { 0.5f * (RegionLabel + 1.0f) };
+	const FVector Center { PlayerPawn->GetActorLocation() };
+	const float StrokeRadius { 2.0f * Brush.Radius };
 	
-	const int32 RegionID {
-		FMath::Clamp(
-			FMath::FloorToInt(RegionLabelNormalized * RegionBucketCount),
-			0,
-			RegionBucketCount - 1
-		) 
+	const float FlattenHeight { SampleHeight(FVector2f { static_cast<float>(Center.X), static_cast<float>(Center.Y) }, TerrainNoiseGroupIndex) };
+	
+	const double StartTime { FPlatformTime::Seconds() };
+	
+	// Consecutive stamps overlap like a continuous stroke circling the player
+	for (int32 EditIndex { 0 }; EditIndex < EditNum; ++EditIndex)
+	{
+		const float Angle { UE_TWO_PI * EditIndex / 64.0f };
+		
+		ApplyTerrainBrush(
+			FVector { 
+				Center.X + StrokeRadius * FMath::Cos(Angle), 
+				Center.Y + StrokeRadius * FMath::Sin(Angle), 
+				FlattenHeight 
+			},
+			Brush
+		);
+	}
+	
+	// Vertex buffer uploads are queued to the render thread and belong in the measurement
+	FlushRenderingCommands();
+	
+	const double ElapsedTime { FPlatformTime::Seconds() - StartTime };
+	const float EditsPerSecond { static_cast<float>(EditNum / FMath::Max(ElapsedTime, UE_DOUBLE_SMALL_NUMBER)) };
+	
+	UE_LOG(
+		LogTemp, 
+		Log, 
+		TEXT("Terrain Brush Benchmark: %d %s edits in %.1f ms, %.0f edits/s"), 
+		EditNum, 
+		*StaticEnum<ETerrainBrushMode>()->GetNameStringByValue(static_cast<int64>(Brush.Mode)),
+		1000.0 * ElapsedTime, 
+		EditsPerSecond
+	);
+	
+	return EditsPerSecond;
+}
+
+void ATerrainGenerator::AddTerrainStamps(const TArray<FTerrainStamp>& StampArray)
+{
+	if (!TerrainConfig)
+	{
+		TerrainStampArray.Append(StampArray);
+		
+		return;
+	}
+	
+	TOptional<FIntRect> DirtyTileRect;
+	
+	for (const FTerrainStamp& Stamp : StampArray)
+	{
+		if (const FIntRect TileRect { TerrainStampLayer.Add(Stamp) }; Stamp.PointArray.Num() > 0)
+		{
+			DirtyTileRect = DirtyTileRect.IsSet() ? DirtyTileRect->Union(TileRect) : TileRect;
+		}
+	}
+	
+	if (DirtyTileRect.IsSet())
+	{
+		// Tiles cover each sector's own vertices, so the sectors behind them share the border vertices
+		RegenerateSectors(FIntRect { DirtyTileRect->Min - FIntPoint { 1 }, DirtyTileRect->Max });
+	}
+}
+
+void ATerrainGenerator::ForEachVertexCorner(
+	const FIntPoint VertexCoordinates, 
+	const TFunctionRef<void(FSectorSlot& Slot, FIntPoint CellCoordinates, int32 VertexIndex)> CornerFunction
+) {
+	const int32 SectorSize { TerrainConfig->SectorSizeInCells };
+	
+	// A grid vertex is corner 0 of the cell at its own position and corners 1 to 3 of the cells behind it
+	const TPair<FIntPoint, int32> CellCornerArray[] {
+		{ FIntPoint { 0, 0 }, 0 },
+		{ FIntPoint { -1, 0 }, 1 },
+		{ FIntPoint { -1, -1 }, 2 },
+		{ FIntPoint { 0, -1 }, 3 }
 	};
+	
+	for (const auto& [CellOffset, Corner] : CellCornerArray)
+	{
+		const FIntPoint WorldCellCoordinates { VertexCoordinates + CellOffset };
+		
+		if (WorldCellCoordinates.X < 0 || WorldCellCoordinates.Y < 0)
+		{
+			continue;
+		}
+		
+		const FIntPoint SectorCoordinates { WorldCellCoordinates / SectorSize };
+		
+		FSectorSlot* Slot { SectorGrid.Find(SectorCoordinates) };
+		
+		if (!Slot || !Slot->bHasRenderData)
+		{
+			continue;
+		}
+		
+		const FIntPoint CellCoordinates { WorldCellCoordinates - SectorCoordinates * SectorSize };
+		
+		CornerFunction(*Slot, CellCoordinates, 4 * (CellCoordinates.Y * SectorSize + CellCoordinates.X) + Corner);
+	}
+}
+
+TOptional<float> ATerrainGenerator::FindVertexHeight(const FIntPoint VertexCoordinates)
+{
+	TOptional<float> Height;
+	
+	ForEachVertexCorner(
+		VertexCoordinates,
+		[&Height](FSectorSlot& Slot, const FIntPoint CellCoordinates, const int32 VertexIndex)
+		{
+			Height = Slot.SectorRenderData.GroundMeshRenderData.VertexArray[VertexIndex].Z;
+		}
+	);
+	
+	return Height;
+}
+
+void ATerrainGenerator::RestartRunningGeneration(const FIntRect& VertexRect)
+{
+	const int32 SectorSize { TerrainConfig->SectorSizeInCells };
+	
+	// A running task may have sampled the edit layer before this edit, so its sectors are requested again
+	const FIntPoint MinSector { (VertexRect.Min - FIntPoint { 1 }).ComponentMax(FIntPoint::ZeroValue) / SectorSize };
+	const FIntPoint MaxSector { (VertexRect.Max - FIntPoint { 1 }) / SectorSize };
+	
+	for (int32 Y { MinSector.Y }; Y <= MaxSector.Y; ++Y)
+	{
+		for (int32 X { MinSector.X }; X <= MaxSector.X; ++X)
+		{
+			if (
+				FSectorSlot* Slot { SectorGrid.Find({ X, Y }) };
+				Slot && Slot->Request && Slot->Request->bRunning
+			) {
+				CancelSectorGeneration(*Slot);
+				RequestSectorGeneration(*Slot);
+			}
+		}
+	}
+}
+
+void ATerrainGenerator::RegenerateSectors(const FIntRect& SectorRect)
+{
+	for (FSectorSlot& Slot : SectorGrid.SlotArray)
+	{
+		if (
+			!Slot.bClaimed ||
+			Slot.SectorCoordinates.X < SectorRect.Min.X || Slot.SectorCoordinates.X > SectorRect.Max.X ||
+			Slot.SectorCoordinates.Y < SectorRect.Min.Y || Slot.SectorCoordinates.Y > SectorRect.Max.Y
+		) {
+			continue;
+		}
+		
+		if (Slot.Request)
+		{
+			// Queued requests sample the new heights when they run
+			if (Slot.Request->bRunning)
+			{
+				CancelSectorGeneration(Slot);
+				RequestSectorGeneration(Slot);
+			}
+			
+			continue;
+		}
+		
+		if (!Slot.bHasRenderData)
+		{
+			continue;
+		}
+		
+		// The committed component keeps showing the old meshes until the new render data arrives
+		Slot.bHasRenderData = false;
+		Slot.bBuildingMeshes = false;
+		
+		CommitQueue.Remove(Slot.SectorCoordinates);
+		
+		RequestSectorGeneration(Slot);
+	}
+	
+	SetActorTickEnabled(!CommitQueue.IsEmpty() || PendingRequestNum > 0);
+}
 
-	return RegionID;
+void ATerrainGenerator::RemoveExpiredSectors(const TSet<FIntPoint>& ExpiredSectorCoordinatesSet)
+{
+	for (const FIntPoint& SectorCoordinates : ExpiredSectorCoordinatesSet)
+	{
+		CommitQueue.Remove(SectorCoordinates);
+		
+		if (FSectorSlot* Slot { SectorGrid.Find(SectorCoordinates) })
+		{
+			CancelSectorGeneration(*Slot);
+			DestroySector(*Slot);
+		}
+	}
 }
 
-uint8 ATerrainGenerator::GetOrAssignRingIndexForRegionID(const int32 RegionID, const FVector2f& RegionPosition) {
-	if (const uint8* RingIndex { RegionIDToRingIndex.Find(RegionID) })
+void ATerrainGenerator::DestroySector(FSectorSlot& Slot)
+{
+	const TObjectPtr<USectorComponent> SectorComponent { Slot.SectorComponent };
+	
+	if (!SectorComponent)
+	{
+		return;
+	}
+	
+	if (SectorComponent->GroundStaticMeshComponent)
+	{
+		SectorComponent->GroundStaticMeshComponent->DestroyComponent();
+	}
+	
+	if (SectorComponent->WaterStaticMeshComponent)
+	{
+		SectorComponent->WaterStaticMeshComponent->DestroyComponent();
+	}
+	
+	if (SectorComponent->GroundDynamicMeshComponent)
+	{
+		SectorComponent->GroundDynamicMeshComponent->DestroyComponent();
+	}
+	
+	if (SectorComponent->WaterDynamicMeshComponent)
 	{
-		return *RingIndex;
+		SectorComponent->WaterDynamicMeshComponent->DestroyComponent();
 	}
+	
+	ReleaseSectorScatter(Slot);
+	
+	SectorComponent->DestroyComponent();
+	
+	Slot.SectorComponent = nullptr;
+	
+	UpdateHorizon(Slot.SectorCoordinates, -1);
+}
+
+FastNoiseLite::CellularCell ATerrainGenerator::GetRegionCell(const FVector2f& WorldPosition) const
+{
+	return BiomeNoise.GetCellularCell(WorldPosition.X, WorldPosition.Y);
+}
 
-	RegionIDToRegionPosition.Add(RegionID, RegionPosition);
+uint8 ATerrainGenerator::GetRingIndexForRegion(const FastNoiseLite::CellularCell& RegionCell) const
+{
+	FVector2f RegionPosition;
+	BiomeNoise.GetCellularPoint(RegionCell.x, RegionCell.y, RegionPosition.X, RegionPosition.Y);
 
 	const float DistanceToCenter {
 		FVector2f::Distance(
@@ -480,92 +2497,194 @@ uint8 ATerrainGenerator::GetOrAssignRingIndexForRegionID(const int32 RegionID, c
 		)
 	};
 
-	const FRingDefinition& Ring { BiomeSet->GetRingDefinition(DistanceToCenter) };
+	return static_cast<uint8>(BiomeSet->GetRingIndex(DistanceToCenter));
+}
 
-	uint8 RingIndex { 0 };
+uint8 ATerrainGenerator::SampleBiomeIndex(const FVector2f& WorldPosition) const
+{
+	return GetBiomeIndexForRegion(GetRegionCell(WorldPosition));
+}
 
-	for (int32 Index { 0 }; Index < BiomeSet->RingDefinitionArray.Num(); ++Index)
+void ATerrainGenerator::SampleBiomeIndices(
+	const TConstArrayView<float> WorldXArray, 
+	const float WorldY, 
+	const FBiomeRegionCandidates& RegionCandidates, 
+	const TArrayView<uint8> BiomeIndexArray
+) const {
+	check(WorldXArray.Num() == BiomeIndexArray.Num());
+	
+	if (RegionCandidates.bSingleRegion)
+	{
+		FMemory::Memset(BiomeIndexArray.GetData(), RegionCandidates.SingleRegionBiomeIndex, BiomeIndexArray.Num());
+		
+		return;
+	}
+	
+	// Fixed-size blocks keep the row on the stack however wide the sampled region is
+	constexpr int32 BlockSize { 256 };
+	
+	float WorldYArray[BlockSize];
+	FastNoiseLite::CellularCell RegionCellArray[BlockSize];
+	
+	for (float& BlockWorldY : WorldYArray)
+	{
+		BlockWorldY = WorldY;
+	}
+	
+	for (int32 BlockStart { 0 }; BlockStart < WorldXArray.Num(); BlockStart += BlockSize)
 	{
-		const FRingDefinition& Candidate = BiomeSet->RingDefinitionArray[Index];
+		const int32 BlockNum { FMath::Min(BlockSize, WorldXArray.Num() - BlockStart) };
+		
+		BiomeNoise.GetCellularCells(
+			WorldXArray.GetData() + BlockStart, 
+			WorldYArray, 
+			RegionCellArray, 
+			BlockNum,
+			RegionCandidates.CandidateArray.GetData(), 
+			RegionCandidates.CandidateArray.Num()
+		);
+		
+#if DO_GUARD_SLOW
+		// Spot-check the batched candidate path against the scalar query on a few samples of the row
+		for (int32 Index { 0 }; Index < BlockNum; Index += 31)
+		{
+			const FastNoiseLite::CellularCell ScalarCell {
+				GetRegionCell(FVector2f { WorldXArray[BlockStart + Index], WorldY })
+			};
 
-		if (&Candidate == &Ring)
+			ensureMsgf(
+				ScalarCell.x == RegionCellArray[Index].x && ScalarCell.y == RegionCellArray[Index].y,
+				TEXT("Batched region cell (%d, %d) differs from scalar cell (%d, %d) at (%f, %f)"),
+				RegionCellArray[Index].x,
+				RegionCellArray[Index].y,
+				ScalarCell.x,
+				ScalarCell.y,
+				WorldXArray[BlockStart + Index],
+				WorldY
+			);
+		}
+#endif
+
+		for (int32 Index { 0 }; Index < BlockNum; ++Index)
 		{
-			RingIndex = static_cast<uint8>(Index);
+			const FastNoiseLite::CellularCell& RegionCell { RegionCellArray[Index] };
 			
-			break;
+			BiomeIndexArray[BlockStart + Index] = RegionCandidates.CandidateBiomeIndexArray.IsValidIndex(RegionCell.candidate)
+				? RegionCandidates.CandidateBiomeIndexArray[RegionCell.candidate]
+				: GetBiomeIndexForRegion(RegionCell);
 		}
 	}
-
-	RegionIDToRingIndex.Add(RegionID, RingIndex);
-
-	return RingIndex;
 }
 
-uint8 ATerrainGenerator::SampleBiomeIndex(const FVector2f& WorldPosition)
-{
-	const int32 RegionID { GetRegionID(WorldPosition) };
-	const uint8 RingIndex { GetOrAssignRingIndexForRegionID(RegionID, WorldPosition) };
+void ATerrainGenerator::GatherRegionCandidates(
+	const FVector2f& MinWorldPosition, 
+	const FVector2f& MaxWorldPosition, 
+	FBiomeRegionCandidates& RegionCandidates
+) const {
+	RegionCandidates.Clear();
 	
-	const FRingDefinition& RingDefinition { BiomeSet->RingDefinitionArray[RingIndex] };
+	// Voronoi regions are convex, so a rectangle whose corners share a region lies inside it
+	const FastNoiseLite::CellularCell CornerCell { GetRegionCell(MinWorldPosition) };
 	
-	if (const uint8* CachedBiome { RegionIDToBiomeIndex.Find(RegionID) })
-	{
-		return *CachedBiome;
-	}
-
-	const float R01 {
-		0.5f * (BiomeNoise.GetNoise(WorldPosition.X, WorldPosition.Y) + 1.0f)
+	const FVector2f CornerPositionArray[] {
+		{ MaxWorldPosition.X, MinWorldPosition.Y },
+		{ MinWorldPosition.X, MaxWorldPosition.Y },
+		{ MaxWorldPosition.X, MaxWorldPosition.Y },
 	};
+	
+	RegionCandidates.bSingleRegion = true;
 
-	TArray<TPair<uint8, float>> Pairs;
-	for (const auto& Pair : RingDefinition.BiomeWeightMap)
-	{
-		Pairs.Add(Pair);
-	}
-
-	// Ensure deterministic order
-	Pairs.Sort([](const TPair<uint8, float>& A, const TPair<uint8, float>& B)
-	{
-		return A.Key < B.Key;
-	});
-
-	float TotalWeight { 0.0f };
-	for (const auto& Pair : Pairs)
+	for (const FVector2f& CornerPosition : CornerPositionArray)
 	{
-		TotalWeight += Pair.Value;
+		if (
+			const FastNoiseLite::CellularCell Cell { GetRegionCell(CornerPosition) };
+			Cell.x != CornerCell.x || Cell.y != CornerCell.y
+		) {
+			RegionCandidates.bSingleRegion = false;
+			
+			break;
+		}
 	}
-
-	if (TotalWeight <= KINDA_SMALL_NUMBER)
+	
+	if (RegionCandidates.bSingleRegion)
 	{
-		return Pairs[0].Key;
+		RegionCandidates.SingleRegionBiomeIndex = GetBiomeIndexForRegion(CornerCell);
+		
+		return;
 	}
 
-	const float Target { R01 * TotalWeight };
-
-	float Accumulator { 0.0f };
-	uint8 BiomeIndex { Pairs[0].Key };
-	bool bPicked { false };
+	int32 CellMinX;
+	int32 CellMinY;
+	int32 CellMaxX;
+	int32 CellMaxY;
+	
+	BiomeNoise.GetCellularCandidateRange(
+		MinWorldPosition.X, 
+		MinWorldPosition.Y, 
+		MaxWorldPosition.X, 
+		MaxWorldPosition.Y, 
+		CellMinX, 
+		CellMinY, 
+		CellMaxX, 
+		CellMaxY
+	);
+	
+	RegionCandidates.CandidateArray.Reserve((CellMaxX - CellMinX + 1) * (CellMaxY - CellMinY + 1));
 
-	for (const auto& Pair : Pairs)
+	for (int32 X { CellMinX }; X <= CellMaxX; ++X)
 	{
-		Accumulator += Pair.Value;
-
-		if (Target <= Accumulator)
+		for (int32 Y { CellMinY }; Y <= CellMaxY; ++Y)
 		{
-			BiomeIndex = Pair.Key;
-			bPicked = true;
-			break;
+			RegionCandidates.CandidateArray.Add(BiomeNoise.GetCellularCandidate(X, Y));
 		}
 	}
-
-	return BiomeIndex;
+	
+	RegionCandidates.CandidateBiomeIndexArray.Reserve(RegionCandidates.CandidateArray.Num());
+	
+	for (int32 CandidateIndex { 0 }; CandidateIndex < RegionCandidates.CandidateArray.Num(); ++CandidateIndex)
+	{
+		const FastNoiseLite::CellularCandidate& Candidate { RegionCandidates.CandidateArray[CandidateIndex] };
+		
+		// Same fields a cellular query returns for this cell, which is all the biome roll reads
+		const FastNoiseLite::CellularCell RegionCell { 
+			Candidate.x, 
+			Candidate.y, 
+			Candidate.hash, 
+			Candidate.hash * (1 / 2147483648.0f), 
+			0.0f, 
+			CandidateIndex 
+		};
+		
+		RegionCandidates.CandidateBiomeIndexArray.Add(GetBiomeIndexForRegion(RegionCell));
+	}
 }
 
-int32 ATerrainGenerator::GetVertexIndex(const FIntPoint GridPosition) const
+uint8 ATerrainGenerator::GetBiomeIndexForRegion(const FastNoiseLite::CellularCell& RegionCell) const
 {
-    const int32 VerticesPerRow { TerrainConfig->SectorSizeInCells + 1 };
+	const TArray<TPair<uint8, float>>& WeightTable { RingBiomeWeightTableArray[GetRingIndexForRegion(RegionCell)] };
+	
+	const float TotalWeight { WeightTable.Last().Value };
+	
+	if (TotalWeight <= KINDA_SMALL_NUMBER)
+	{
+		return WeightTable[0].Key;
+	}
+	
+	const float Target { 0.5f * (RegionCell.value + 1.0f) * TotalWeight };
+	
+	// First biome whose cumulative weight reaches the target
+	const int32 PairIndex {
+		Algo::LowerBoundBy(
+			WeightTable, 
+			Target, 
+			[](const TPair<uint8, float>& Pair)
+			{
+				return Pair.Value;
+			}
+		)
+	};
 	
-	return GridPosition.Y * VerticesPerRow + GridPosition.X;
+	return WeightTable.IsValidIndex(PairIndex) ? WeightTable[PairIndex].Key : WeightTable[0].Key;
 }
 
 void ATerrainGenerator::SetPlayerPosition(const FVector& WorldPosition) const
@@ -2,13 +2,31 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Containers/Queue.h"
+#include "Engine/StreamableManager.h"
+#include "Tasks/Task.h"
 #include "Components/SkyLightComponent.h"
 #include "../ThirdParty/FastNoiseLite/FastNoiseLite.h"
 #include "Components/SectorComponent.h"
+#include "Data/BiomeRegionCandidates.h"
 #include "Data/BiomeSet.h"
+#include "Data/ErosionSettings.h"
+#include "Data/HorizonSettings.h"
+#include "Data/NoiseProgram.h"
+#include "Data/RiverNetwork.h"
+#include "Data/RiverSettings.h"
+#include "Data/SectorMeshBackend.h"
 #include "Data/SectorMeshes.h"
+#include "Data/SectorGrid.h"
 #include "Data/SectorRenderData.h"
+#include "Data/StreamingTargets.h"
+#include "Data/TerrainBrush.h"
+#include "Data/TerrainEditLayer.h"
+#include "Data/TerrainErosionCache.h"
+#include "Data/TerrainStampLayer.h"
+#include "Data/TerrainSampleRegionPool.h"
 #include "Data/TerrainConfig.h"
+#include "Data/VoxelSettings.h"
 #include "TerrainGenerator.generated.h"
 
 
@@ -20,74 +38,316 @@ class ATerrainGenerator : public AActor
 public:	
 	ATerrainGenerator();
 
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Terrain")
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	TSoftObjectPtr<UTerrainConfig> TerrainConfigAsset;
+	
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	TSoftObjectPtr<UBiomeSet> BiomeSetAsset;
+
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	TSoftObjectPtr<UMaterialInterface> TerrainMaterialAsset;
+	
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	TSoftObjectPtr<UMaterialInterface> WaterMaterialAsset;
+
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Terrain")
 	TObjectPtr<UTerrainConfig> TerrainConfig;
 	
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Terrain")
+	UPROPERTY(Transient, BlueprintReadOnly, Category = "Terrain")
 	TObjectPtr<UBiomeSet> BiomeSet;
 
-	UPROPERTY(EditAnywhere, Category = "Terrain")
+	UPROPERTY(Transient)
 	TObjectPtr<UMaterialInterface> TerrainMaterial;
 	
-	UPROPERTY(EditAnywhere, Category = "Terrain")
+	UPROPERTY(Transient)
 	TObjectPtr<UMaterialInterface> WaterMaterial;
 	
 	UPROPERTY(VisibleAnywhere)
 	TObjectPtr<USkyLightComponent> SkyLightComponent;
+	
+	// Seconds of player movement to stream ahead along the velocity and view direction
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming")
+	float PrefetchLookaheadTime;
+	
+	// Upper bound on how far ahead prefetching reaches, which also sizes the resident sector window
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming")
+	int32 MaxPrefetchDistanceInSectors;
+	
+	// Game thread time per frame spent registering finished sectors and building their meshes
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming")
+	float CommitBudgetMilliseconds;
+	
+	// Largest block of adjacent queued sectors that one generation task samples as a single region
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Streaming")
+	int32 MaxGenerationBatchSectorNum;
+	
+	// Editor only: build sector meshes through a mesh description and the full static mesh build instead of writing render buffers directly
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	bool bBuildFromMeshDescription;
+	
+	// Dynamic mesh sectors can patch edited vertices in place, static mesh sectors are rebuilt whole
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	ESectorMeshBackend SectorMeshBackend;
+	
+	// Roads, pads and craters stamped over the noise heights when the terrain is set up
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	TArray<FTerrainStamp> TerrainStampArray;
+	
+	// Hydraulic erosion of the noise heights, run once per sector and cached for later visits
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	FErosionSettings ErosionSettings;
+	
+	// Rivers routed over the whole world at setup and carved into the sectors they cross
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	FRiverSettings RiverSettings;
+	
+	// Contours sectors from a 3D density so overhangs and caves can form where the mask allows them
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	FVoxelSettings VoxelSettings;
+	
+	// One coarse mesh of the low-frequency terrain over the whole world, hidden where streamed sectors cover it
+	UPROPERTY(EditAnywhere, Category = "Terrain")
+	FHorizonSettings HorizonSettings;
+
+	virtual void Tick(float DeltaTime) override;
+	
+	// Pushes the slot's current render data for the cells in [Min, Max) to the committed sector meshes
+	void UpdateSectorMesh(const FIntPoint SectorCoordinates, const FIntRect& CellRect);
+	
+	// Applies one brush stamp at WorldLocation, whose height is the flatten target
+	UFUNCTION(BlueprintCallable, Category = "Terrain")
+	void ApplyTerrainBrush(const FVector& WorldLocation, const FTerrainBrush& Brush);
+	
+	// Strokes the brush in a loop around the player and returns the sustained edits per second
+	UFUNCTION(BlueprintCallable, Category = "Terrain")
+	float BenchmarkTerrainBrush(const FTerrainBrush& Brush, const int32 EditNum);
+	
+	// Adds stamps over the noise heights and regenerates the sectors they overlap
+	UFUNCTION(BlueprintCallable, Category = "Terrain")
+	void AddTerrainStamps(const TArray<FTerrainStamp>& StampArray);
 
 protected:
 	virtual void OnConstruction(const FTransform& Transform) override;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
-	FTimerHandle StreamingTimer;
+	TWeakObjectPtr<USceneComponent> TrackedComponent;
+	FDelegateHandle TransformUpdatedHandle;
+	
+	TOptional<FStreamingTargets> StreamingTargets;
+	TSet<FIntPoint> StreamingSectorCoordinatesSet;
 	
-	FastNoiseLite TerrainNoise;
 	FastNoiseLite BiomeNoise;
+	FastNoiseLite VoxelDensityNoise;
+	FastNoiseLite VoxelMaskNoise;
 
-	const FNoiseGroup* TerrainNoiseGroup;
-	const FNoiseGroup* WaterNoiseGroup;
+	FNoiseProgram NoiseProgram;
+	
+	int32 TerrainNoiseGroupIndex;
+	int32 WaterNoiseGroupIndex;
 	
 	static constexpr int32 ViewRadius { 1 };
+	
+	// Smallest amount of per-row work worth handing to another worker
+	static constexpr int32 MinRowChunkCellNum { 4096 };
 
 	UPROPERTY()
-	TMap<FIntPoint, TObjectPtr<USectorComponent>> ActiveSectorMap;
+	FSectorGrid SectorGrid;
+	
+	int32 MaxRunningGenerationNum;
+	int32 PendingRequestNum;
+	
+	TArray<TSharedRef<FSectorGenerationRequest>> QueuedRequestArray;
+	TArray<UE::Tasks::FTask> GenerationTaskArray;
+	TQueue<TSharedPtr<FSectorGenerationRequest>, EQueueMode::Mpsc> GeneratedRequestQueue;
+	
+	TArray<FIntPoint> CommitQueue;
+	
+	mutable FTerrainSampleRegionPool SampleRegionPool;
+	
+	TArray<FSectorRenderData> SpareRenderDataArray;
+	
+	FTerrainEditLayer TerrainEditLayer;
+	FTerrainStampLayer TerrainStampLayer;
+	mutable FTerrainErosionCache ErosionCache;
+	
+	int32 ErosionHaloInCells;
+	
+	FRiverNetwork RiverNetwork;
+	
+	// Cells sampled beyond every region so voxel sectors can contour the cubes they share with their neighbors
+	int32 VoxelApronInCells;
 	
-	TMap<FIntPoint, FSectorRenderData> SectorRenderDataMap;
-
 	UPROPERTY()
-	TMap<FIntPoint, FSectorMeshes> StaticMeshMap;
+	TObjectPtr<UDynamicMeshComponent> HorizonGroundMeshComponent;
+	
+	UPROPERTY()
+	TObjectPtr<UDynamicMeshComponent> HorizonWaterMeshComponent;
+	
+	FMeshRenderData HorizonGroundMeshRenderData;
+	FMeshRenderData HorizonWaterMeshRenderData;
 	
-	static TObjectPtr<UTerrainConfig> LoadTerrainConfig(const TCHAR* Path);
-	static TObjectPtr<UBiomeSet> LoadBiomeSet(const TCHAR* Path);
-	static TObjectPtr<UMaterialInterface> LoadMaterial(const TCHAR* Path);
-	static const FNoiseGroup* LoadNoiseGroup(const FString& Name, const TArray<FNoiseGroup>& NoiseGroupArray);
+	// Mesh triangle ID per horizon render data triangle, INDEX_NONE while hidden
+	TArray<int32> HorizonGroundTriangleIDArray;
+	TArray<int32> HorizonWaterTriangleIDArray;
+	
+	// Committed sectors over each horizon cell, which is hidden once every sector it overlaps is committed
+	TArray<int32> HorizonCoverageArray;
+	
+	// Each ring's biomes in key order with their cumulative weights, so region lookups neither allocate nor sort
+	TArray<TArray<TPair<uint8, float>>> RingBiomeWeightTableArray;
+	
+	// Every biome's scatter rules flattened in biome set order, as biome index and rule index within the biome
+	TArray<TPair<uint8, int32>> ScatterRuleArray;
+	
+	TArray<TOptional<float>> BrushHeightArray;
+	TArray<TPair<FIntPoint, float>> BrushHeightDeltaArray;
+	
+	TSharedPtr<FStreamableHandle> ConfigAssetsHandle;
+	
+	double StartupTime;
+	bool bAwaitingFirstPlayableFrame;
+	
+	void LoadConfigAssets();
+	void OnConfigAssetsLoaded();
+	
+	void GenerateSpawnSectors(const FIntPoint SpawnSectorCoordinates);
+	void SetPlayerControlEnabled(const bool bEnabled) const;
 
 	void SetupSkyLightComponent();
 	void SetupNoiseGeneration();
+	void SetupBiomeWeights();
+	void SetupNoiseProgram();
+	void SetupPlayerTracking();
+	void SetupSectorGrid();
+	void SetupSampleRegionPool();
+	void SetupScatterRules();
+	void SetupErosion();
+	void SetupRiverNetwork();
+	void SetupVoxelTerrain();
+	void SetupHorizon();
+	
+	void UpdateHorizon(const FIntPoint SectorCoordinates, const int32 CoverageDelta);
+	
+	void OnPlayerTransformUpdated(
+		USceneComponent* UpdatedComponent, 
+		EUpdateTransformFlags UpdateTransformFlags, 
+		ETeleportType TeleportType
+	);
 
-	TObjectPtr<USectorComponent> GenerateSector(const FIntPoint SectorCoordinates);
+	TObjectPtr<USectorComponent> GenerateSector(FSectorSlot& Slot);
+	void DestroySector(FSectorSlot& Slot);
 	
-	void GenerateSectorRenderData(const TObjectPtr<USectorComponent> SectorComponent);
+	FSectorSlot& ClaimSectorSlot(const FIntPoint SectorCoordinates);
+	void ReleaseSectorSlot(FSectorSlot& Slot);
 	
-	float SampleHeight(const FVector2f WorldPosition, const FNoiseGroup* NoiseGroup);
-	uint8 SampleBiomeIndex(const FVector2f& WorldPosition);
+	bool GenerateSectorRenderData(
+		const FIntPoint SectorCoordinates, 
+		FSectorRenderData& SectorRenderData, 
+		const std::atomic<bool>& bCancelled
+	) const;
 	
-	int32 GetRegionID(const FVector2f& WorldPosition) const;
-	uint8 GetOrAssignRingIndexForRegionID(const int32 RegionID, const FVector2f& RegionPosition);
+	void GenerateSectorBatchRenderData(
+		const FIntRect& BatchRect, 
+		const TArray<TSharedRef<FSectorGenerationRequest>>& BatchRequestArray
+	) const;
 	
-	TMap<int32, uint8> RegionIDToRingIndex;
-	TMap<int32, FVector2f> RegionIDToRegionPosition;
+	bool SampleRegion(
+		const FIntPoint OriginInCells,
+		const FIntPoint SizeInCells,
+		FTerrainSampleRegion& Region,
+		const TFunctionRef<bool()> IsCancelled
+	) const;
 	
-	FIntPoint GetPlayerSector() const;
+	void BuildSectorRenderData(
+		const FTerrainSampleRegion& Region,
+		const FIntPoint SectorCoordinates,
+		FSectorRenderData& SectorRenderData
+	) const;
 	
-	static TSet<FIntPoint> ComputeVisibleSet(const FIntPoint& PlayerSector, const TObjectPtr<UTerrainConfig> TerrainConfig);
+	static void ForEachRowChunk(
+		const int32 RowNum, 
+		const int32 CellsPerRow, 
+		const TFunctionRef<void(int32 RowBegin, int32 RowEnd)> ChunkFunction
+	);
+	
+	void RequestSectorGeneration(FSectorSlot& Slot);
+	void CancelSectorGeneration(FSectorSlot& Slot);
+	void DispatchSectorGeneration();
+	
+	FIntRect GatherGenerationBatch(
+		const FIntPoint LeadSectorCoordinates, 
+		TArray<TSharedRef<FSectorGenerationRequest>>& BatchRequestArray
+	);
+	
+	void UpdateGenerationPriorities();
+	int32 GetGenerationPriority(const FIntPoint SectorCoordinates) const;
+	void ReceiveGeneratedSectors();
+	void CommitSectors();
+	void CommitSector(FSectorSlot& Slot);
+	void CommitSectorStaticMeshes(FSectorSlot& Slot);
+	void CommitSectorDynamicMeshes(FSectorSlot& Slot);
+	void SetupSectorMaterials(UMeshComponent* GroundMeshComponent, UMeshComponent* WaterMeshComponent) const;
+	void CommitSectorScatter(FSectorSlot& Slot);
+	void ReleaseSectorScatter(FSectorSlot& Slot);
+	void ReleaseSectorMeshes(FSectorSlot& Slot);
+	
+	void ForEachVertexCorner(
+		const FIntPoint VertexCoordinates, 
+		const TFunctionRef<void(FSectorSlot& Slot, FIntPoint CellCoordinates, int32 VertexIndex)> CornerFunction
+	);
+	
+	TOptional<float> FindVertexHeight(const FIntPoint VertexCoordinates);
+	void RestartRunningGeneration(const FIntRect& VertexRect);
+	void RegenerateSectors(const FIntRect& SectorRect);
+	
+#if WITH_EDITOR
+	void CommitSectorBatch();
+	void OnSectorMeshesBuilt(const FIntPoint SectorCoordinates, const uint32 MeshBuildId, const FSectorMeshes& SectorMeshes);
+#endif
+	
+	float SampleHeight(const FVector2f WorldPosition, const int32 NoiseGroupIndex) const;
+	
+	void SampleHeightFields(FTerrainSampleRegion& Region) const;
 	
-	void AddMissingSectors(const TSet<FIntPoint>& VisibleSectorCoordinatesSet);
-	void RemoveExpiredSectors(const TSet<FIntPoint>& VisibleSectorCoordinatesSet);
-	void UpdateVisibleSectors();
+	void SampleCoarseNoiseLayer(
+		FTerrainSampleRegion& Region, 
+		const int32 LayerIndex, 
+		const int32 LatticeStep
+	) const;
+	
+	static float CubicInterpolate(const float P0, const float P1, const float P2, const float P3, const float Alpha);
+	
+	uint8 SampleBiomeIndex(const FVector2f& WorldPosition) const;
+	
+	void SampleBiomeIndices(
+		const TConstArrayView<float> WorldXArray, 
+		const float WorldY, 
+		const FBiomeRegionCandidates& RegionCandidates, 
+		const TArrayView<uint8> BiomeIndexArray
+	) const;
+	
+	void GatherRegionCandidates(
+		const FVector2f& MinWorldPosition, 
+		const FVector2f& MaxWorldPosition, 
+		FBiomeRegionCandidates& RegionCandidates
+	) const;
+	
+	FastNoiseLite::CellularCell GetRegionCell(const FVector2f& WorldPosition) const;
+	uint8 GetRingIndexForRegion(const FastNoiseLite::CellularCell& RegionCell) const;
+	uint8 GetBiomeIndexForRegion(const FastNoiseLite::CellularCell& RegionCell) const;
+	
+	FIntPoint GetSectorCoordinates(const FVector& Location) const;
+	
+	FStreamingTargets ComputeStreamingTargets(const APawn* PlayerPawn) const;
+	TSet<FIntPoint> ComputeStreamingSet(const FStreamingTargets& Targets) const;
+	
+	static TSet<FIntPoint> ComputeVisibleSet(const FIntPoint& PlayerSector, const TObjectPtr<UTerrainConfig> TerrainConfig);
 	
-	int32 GetVertexIndex(const FIntPoint GridPosition) const;
+	void AddMissingSectors(const TSet<FIntPoint>& MissingSectorCoordinatesSet);
+	void RemoveExpiredSectors(const TSet<FIntPoint>& ExpiredSectorCoordinatesSet);
+	void UpdateVisibleSectors(const FStreamingTargets& NewStreamingTargets);
 	
 	void SetPlayerPosition(const FVector& WorldPosition) const;
 };
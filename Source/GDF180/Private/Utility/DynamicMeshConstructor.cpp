@@ -0,0 +1,173 @@
+#include "DynamicMeshConstructor.h"
+#include "Components/DynamicMeshComponent.h"
+#include "DynamicMesh/DynamicMesh3.h"
+#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "DynamicMesh/MeshNormals.h"
+
+using namespace UE::Geometry;
+
+
+void FDynamicMeshConstructor::Run(
+	UDynamicMeshComponent* DynamicMeshComponent,
+	const FMeshRenderData& MeshRenderData,
+	const bool bGenerateCollision
+) {
+	FDynamicMesh3 DynamicMesh;
+	DynamicMesh.EnableAttributes();
+	DynamicMesh.Attributes()->EnablePrimaryColors();
+
+	FDynamicMeshUVOverlay* UVOverlay { DynamicMesh.Attributes()->PrimaryUV() };
+	FDynamicMeshNormalOverlay* NormalOverlay { DynamicMesh.Attributes()->PrimaryNormals() };
+	FDynamicMeshColorOverlay* ColorOverlay { DynamicMesh.Attributes()->PrimaryColors() };
+
+	// Vertices and overlay elements are appended in render data order, so one index addresses all of them
+	for (int32 Index { 0 }; Index < MeshRenderData.VertexArray.Num(); ++Index)
+	{
+		DynamicMesh.AppendVertex(FVector3d { MeshRenderData.VertexArray[Index] });
+		
+		UVOverlay->AppendElement(MeshRenderData.UVArray[Index]);
+		NormalOverlay->AppendElement(FVector3f::UpVector);
+		ColorOverlay->AppendElement(MeshRenderData.VertexColorArray[Index]);
+	}
+
+	for (int32 Index { 0 }; Index < MeshRenderData.IndexArray.Num(); Index += 3)
+	{
+		const FIndex3i Triangle {
+			static_cast<int32>(MeshRenderData.IndexArray[Index + 0]),
+			static_cast<int32>(MeshRenderData.IndexArray[Index + 1]),
+			static_cast<int32>(MeshRenderData.IndexArray[Index + 2])
+		};
+		
+		const int32 TriangleID { DynamicMesh.AppendTriangle(Triangle) };
+		
+		UVOverlay->SetTriangle(TriangleID, Triangle);
+		NormalOverlay->SetTriangle(TriangleID, Triangle);
+		ColorOverlay->SetTriangle(TriangleID, Triangle);
+	}
+
+	for (const int32 VertexID : DynamicMesh.VertexIndicesItr())
+	{
+		NormalOverlay->SetElement(VertexID, FVector3f { FMeshNormals::QuickComputeVertexNormal(DynamicMesh, VertexID) });
+	}
+
+	DynamicMeshComponent->SetMesh(MoveTemp(DynamicMesh));
+	DynamicMeshComponent->SetVertexColorSpaceTransformMode(EDynamicMeshVertexColorTransformMode::LinearToSRGB);
+	
+	if (bGenerateCollision)
+	{
+		DynamicMeshComponent->bUseAsyncCooking = true;
+		DynamicMeshComponent->SetComplexAsSimpleCollisionEnabled(true, true);
+	}
+	else
+	{
+		DynamicMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	}
+}
+
+void FDynamicMeshConstructor::UpdateVertices(
+	UDynamicMeshComponent* DynamicMeshComponent,
+	const FMeshRenderData& MeshRenderData,
+	const TConstArrayView<int32> VertexIndexArray
+) {
+	FDynamicMesh3* DynamicMesh { DynamicMeshComponent->GetMesh() };
+	
+	for (const int32 VertexIndex : VertexIndexArray)
+	{
+		DynamicMesh->SetVertex(VertexIndex, FVector3d { MeshRenderData.VertexArray[VertexIndex] });
+	}
+	
+	FDynamicMeshNormalOverlay* NormalOverlay { DynamicMesh->Attributes()->PrimaryNormals() };
+
+	for (const int32 VertexIndex : VertexIndexArray)
+	{
+		NormalOverlay->SetElement(VertexIndex, FVector3f { FMeshNormals::QuickComputeVertexNormal(*DynamicMesh, VertexIndex) });
+	}
+	
+	// Only the vertex buffers are re-uploaded, the proxy and index buffers are kept
+	DynamicMeshComponent->FastNotifyPositionsUpdated(true);
+	
+	if (DynamicMeshComponent->GetCollisionEnabled() != ECollisionEnabled::NoCollision)
+	{
+		DynamicMeshComponent->UpdateCollision(false);
+	}
+}
+
+void FDynamicMeshConstructor::UpdateTriangles(
+	UDynamicMeshComponent* DynamicMeshComponent,
+	const FMeshRenderData& MeshRenderData,
+	const TConstArrayView<int32> HiddenTriangleArray,
+	const TConstArrayView<int32> ShownTriangleArray,
+	TArray<int32>& TriangleIDArray
+) {
+	// An empty ID array belongs to a mesh built from empty render data, which has no triangles to hide or show
+	if (TriangleIDArray.IsEmpty() || (HiddenTriangleArray.IsEmpty() && ShownTriangleArray.IsEmpty()))
+	{
+		return;
+	}
+	
+	FDynamicMesh3* DynamicMesh { DynamicMeshComponent->GetMesh() };
+	
+	for (const int32 TriangleIndex : HiddenTriangleArray)
+	{
+		if (int32& TriangleID { TriangleIDArray[TriangleIndex] }; TriangleID != INDEX_NONE)
+		{
+			// Vertices stay behind, but overlay elements are freed along with the last triangle using them
+			DynamicMesh->RemoveTriangle(TriangleID, false);
+			TriangleID = INDEX_NONE;
+		}
+	}
+	
+	FDynamicMeshUVOverlay* UVOverlay { DynamicMesh->Attributes()->PrimaryUV() };
+	FDynamicMeshNormalOverlay* NormalOverlay { DynamicMesh->Attributes()->PrimaryNormals() };
+	FDynamicMeshColorOverlay* ColorOverlay { DynamicMesh->Attributes()->PrimaryColors() };
+	
+	TArray<int32> RestoredVertexArray;
+	
+	for (const int32 TriangleIndex : ShownTriangleArray)
+	{
+		int32& TriangleID { TriangleIDArray[TriangleIndex] };
+		
+		if (TriangleID != INDEX_NONE)
+		{
+			continue;
+		}
+		
+		const FIndex3i Triangle {
+			static_cast<int32>(MeshRenderData.IndexArray[3 * TriangleIndex + 0]),
+			static_cast<int32>(MeshRenderData.IndexArray[3 * TriangleIndex + 1]),
+			static_cast<int32>(MeshRenderData.IndexArray[3 * TriangleIndex + 2])
+		};
+		
+		TriangleID = DynamicMesh->AppendTriangle(Triangle);
+		
+		if (TriangleID < 0)
+		{
+			TriangleID = INDEX_NONE;
+			continue;
+		}
+		
+		// Elements freed while hidden are reinserted under their vertex ID, so one index still addresses all of them
+		for (int32 Corner { 0 }; Corner < 3; ++Corner)
+		{
+			if (const int32 VertexID { Triangle[Corner] }; !NormalOverlay->IsElement(VertexID))
+			{
+				UVOverlay->InsertElement(VertexID, &MeshRenderData.UVArray[VertexID].X);
+				NormalOverlay->InsertElement(VertexID, &FVector3f::UpVector.X);
+				ColorOverlay->InsertElement(VertexID, &MeshRenderData.VertexColorArray[VertexID].X);
+				
+				RestoredVertexArray.Add(VertexID);
+			}
+		}
+		
+		UVOverlay->SetTriangle(TriangleID, Triangle);
+		NormalOverlay->SetTriangle(TriangleID, Triangle);
+		ColorOverlay->SetTriangle(TriangleID, Triangle);
+	}
+	
+	for (const int32 VertexID : RestoredVertexArray)
+	{
+		NormalOverlay->SetElement(VertexID, FVector3f { FMeshNormals::QuickComputeVertexNormal(*DynamicMesh, VertexID) });
+	}
+	
+	DynamicMeshComponent->NotifyMeshUpdated();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Data/MeshRenderData.h"
+
+
+class UDynamicMeshComponent;
+
+struct FDynamicMeshConstructor
+{
+	static void Run(
+		UDynamicMeshComponent* DynamicMeshComponent,
+		const FMeshRenderData& MeshRenderData,
+		const bool bGenerateCollision = false
+	);
+	
+	// Copies the listed vertices from the render data into the existing mesh without rebuilding it
+	static void UpdateVertices(
+		UDynamicMeshComponent* DynamicMeshComponent,
+		const FMeshRenderData& MeshRenderData,
+		const TConstArrayView<int32> VertexIndexArray
+	);
+	
+	// Removes and re-adds render data triangles, tracking the mesh triangle ID of each visible one in TriangleIDArray
+	static void UpdateTriangles(
+		UDynamicMeshComponent* DynamicMeshComponent,
+		const FMeshRenderData& MeshRenderData,
+		const TConstArrayView<int32> HiddenTriangleArray,
+		const TConstArrayView<int32> ShownTriangleArray,
+		TArray<int32>& TriangleIDArray
+	);
+};
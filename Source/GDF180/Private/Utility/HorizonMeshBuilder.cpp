@@ -0,0 +1,128 @@
+#include "HorizonMeshBuilder.h"
+#include "../Data/TerrainConfig.h"
+#include "Async/ParallelFor.h"
+
+
+void FHorizonMeshBuilder::Run(
+	const FHorizonSettings& HorizonSettings,
+	const UTerrainConfig* TerrainConfig,
+	const FNoiseProgram& NoiseProgram,
+	const int32 NoiseGroupIndex,
+	const TFunctionRef<FVector4f(FVector2f WorldPosition)> GetVertexColor,
+	FMeshRenderData& MeshRenderData
+) {
+	MeshRenderData.Clear();
+	
+	if (!NoiseProgram.GroupArray.IsValidIndex(NoiseGroupIndex))
+	{
+		return;
+	}
+	
+	const int32 CellNum { GetCellNum(HorizonSettings, TerrainConfig) };
+	const int32 VertexNum { CellNum + 1 };
+	
+	const float Spacing { FMath::Max(1, HorizonSettings.CellSizeInCells) * TerrainConfig->CellSizeInCentimeters };
+	const float SectorSizeInCentimeters { TerrainConfig->GetSectorSizeInCentimeters() };
+	
+	// Shorter layers would alias at this spacing, and their detail is lost at horizon distance anyway
+	TArray<FNoiseProgramTerm, TInlineAllocator<8>> TermArray;
+	
+	for (const FNoiseProgramTerm& Term : NoiseProgram.GroupArray[NoiseGroupIndex].TermArray)
+	{
+		if (NoiseProgram.LayerArray[Term.LayerIndex].Period >= 2.0f * Spacing)
+		{
+			TermArray.Add(Term);
+		}
+	}
+	
+	MeshRenderData.VertexArray.SetNumUninitialized(VertexNum * VertexNum);
+	MeshRenderData.UVArray.SetNumUninitialized(VertexNum * VertexNum);
+	MeshRenderData.VertexColorArray.SetNumUninitialized(VertexNum * VertexNum);
+	MeshRenderData.IndexArray.SetNumUninitialized(6 * CellNum * CellNum);
+	
+	ParallelFor(
+		VertexNum,
+		[&](const int32 Y)
+		{
+			for (int32 X { 0 }; X < VertexNum; ++X)
+			{
+				const FVector2f WorldPosition { X * Spacing, Y * Spacing };
+				
+				float Height { -HorizonSettings.SinkDepth };
+				
+				for (const auto& [LayerIndex, Scale] : TermArray)
+				{
+					Height += Scale * NoiseProgram.SampleLayer(LayerIndex, WorldPosition);
+				}
+				
+				const int32 VertexIndex { Y * VertexNum + X };
+				
+				MeshRenderData.VertexArray[VertexIndex] = FVector3f { WorldPosition.X, WorldPosition.Y, Height };
+				MeshRenderData.UVArray[VertexIndex] = WorldPosition / SectorSizeInCentimeters;
+				MeshRenderData.VertexColorArray[VertexIndex] = GetVertexColor(WorldPosition);
+			}
+			
+			if (Y == CellNum)
+			{
+				return;
+			}
+			
+			for (int32 X { 0 }; X < CellNum; ++X)
+			{
+				const uint32 VertexBase { static_cast<uint32>(Y * VertexNum + X) };
+				
+				// Corners in the same order and winding as a sector cell
+				const uint32 Corner0 { VertexBase };
+				const uint32 Corner1 { VertexBase + 1 };
+				const uint32 Corner2 { VertexBase + VertexNum + 1 };
+				const uint32 Corner3 { VertexBase + VertexNum };
+				
+				const uint32 CellIndexArray[] {
+					Corner0, Corner2, Corner1,
+					Corner0, Corner3, Corner2
+				};
+				
+				FMemory::Memcpy(&MeshRenderData.IndexArray[6 * (Y * CellNum + X)], CellIndexArray, sizeof(CellIndexArray));
+			}
+		}
+	);
+}
+
+int32 FHorizonMeshBuilder::GetCellNum(const FHorizonSettings& HorizonSettings, const UTerrainConfig* TerrainConfig)
+{
+	return FMath::DivideAndRoundUp(
+		TerrainConfig->WorldSizeInSectors * TerrainConfig->SectorSizeInCells, 
+		FMath::Max(1, HorizonSettings.CellSizeInCells)
+	);
+}
+
+FIntRect FHorizonMeshBuilder::GetOverlappedCellRect(const FHorizonSettings& HorizonSettings, const FIntRect& CellRect)
+{
+	const int32 CellSizeInCells { FMath::Max(1, HorizonSettings.CellSizeInCells) };
+	
+	return FIntRect {
+		FIntPoint::DivideAndRoundDown(CellRect.Min, CellSizeInCells),
+		FIntPoint::DivideAndRoundUp(CellRect.Max, CellSizeInCells)
+	};
+}
+
+int32 FHorizonMeshBuilder::GetOverlappedSectorNum(
+	const FHorizonSettings& HorizonSettings, 
+	const UTerrainConfig* TerrainConfig, 
+	const FIntPoint HorizonCellCoordinates
+) {
+	const int32 CellSizeInCells { FMath::Max(1, HorizonSettings.CellSizeInCells) };
+	const int32 SectorSize { TerrainConfig->SectorSizeInCells };
+	
+	// The last horizon cell can reach past the world, where there are no sectors to wait for
+	const FIntPoint CellMin { HorizonCellCoordinates * CellSizeInCells };
+	const FIntPoint CellMax { 
+		((HorizonCellCoordinates + FIntPoint { 1 }) * CellSizeInCells).ComponentMin(FIntPoint { TerrainConfig->WorldSizeInSectors * SectorSize }) 
+	};
+	
+	const FIntPoint SectorNum { 
+		FIntPoint::DivideAndRoundUp(CellMax, SectorSize) - FIntPoint::DivideAndRoundDown(CellMin, SectorSize) 
+	};
+	
+	return SectorNum.X * SectorNum.Y;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Data/HorizonSettings.h"
+#include "../Data/MeshRenderData.h"
+#include "../Data/NoiseProgram.h"
+
+
+class UTerrainConfig;
+
+struct FHorizonMeshBuilder
+{
+	// One shared-vertex grid over the whole world with two triangles per horizon cell, in cell order
+	static void Run(
+		const FHorizonSettings& HorizonSettings,
+		const UTerrainConfig* TerrainConfig,
+		const FNoiseProgram& NoiseProgram,
+		const int32 NoiseGroupIndex,
+		const TFunctionRef<FVector4f(FVector2f WorldPosition)> GetVertexColor,
+		FMeshRenderData& MeshRenderData
+	);
+	
+	static int32 GetCellNum(const FHorizonSettings& HorizonSettings, const UTerrainConfig* TerrainConfig);
+	
+	// Horizon cells overlapping a rect of terrain cells, Max exclusive
+	static FIntRect GetOverlappedCellRect(const FHorizonSettings& HorizonSettings, const FIntRect& CellRect);
+	
+	// Sectors of the world that a horizon cell overlaps
+	static int32 GetOverlappedSectorNum(
+		const FHorizonSettings& HorizonSettings, 
+		const UTerrainConfig* TerrainConfig, 
+		const FIntPoint HorizonCellCoordinates
+	);
+};
@@ -0,0 +1,143 @@
+#include "NoiseProgramCompiler.h"
+#include "../Data/TerrainConfig.h"
+
+
+FNoiseProgram FNoiseProgramCompiler::Run(const UTerrainConfig* TerrainConfig)
+{
+	FNoiseProgram NoiseProgram;
+
+	for (const FNoiseGroup& NoiseGroup : TerrainConfig->NoiseGroupArray)
+	{
+		FNoiseProgramGroup& ProgramGroup { NoiseProgram.GroupArray.AddDefaulted_GetRef() };
+		ProgramGroup.Name = NoiseGroup.Name;
+
+		for (const auto& [Weight, Period, Amplitude] : NoiseGroup.NoiseLayerArray)
+		{
+			const float Scale { Weight * Amplitude };
+
+			if (Scale == 0.0f)
+			{
+				continue;
+			}
+
+			if (Period <= 0.0f)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("Skipped layer with period %f in group: %s"), Period, *NoiseGroup.Name);
+				
+				continue;
+			}
+
+			// Every layer shares the terrain seed, so layers with the same period produce the same noise
+			int32 LayerIndex {
+				NoiseProgram.LayerArray.IndexOfByPredicate(
+					[&](const FNoiseProgramLayer& Candidate)
+					{
+						return Candidate.Period == Period;
+					}
+				)
+			};
+
+			if (LayerIndex == INDEX_NONE)
+			{
+				LayerIndex = NoiseProgram.LayerArray.Num();
+				
+				FNoiseProgramLayer& ProgramLayer { NoiseProgram.LayerArray.AddDefaulted_GetRef() };
+				ProgramLayer.Period = Period;
+				ProgramLayer.Noise.SetSeed(TerrainConfig->Seed);
+				ProgramLayer.Noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
+				ProgramLayer.Noise.SetFrequency(1.0f / Period);
+			}
+
+			if (
+				FNoiseProgramTerm* Term { 
+					ProgramGroup.TermArray.FindByPredicate(
+						[&](const FNoiseProgramTerm& Candidate)
+						{
+							return Candidate.LayerIndex == LayerIndex;
+						}
+					) 
+				}
+			) {
+				Term->Scale += Scale;
+			}
+			else
+			{
+				ProgramGroup.TermArray.Add({ LayerIndex, Scale });
+			}
+		}
+
+		ProgramGroup.TermArray.RemoveAll(
+			[](const FNoiseProgramTerm& Term)
+			{
+				return Term.Scale == 0.0f;
+			}
+		);
+	}
+
+	TArray<int32> LayerIndexMap;
+	LayerIndexMap.Init(INDEX_NONE, NoiseProgram.LayerArray.Num());
+
+	for (const FNoiseProgramGroup& ProgramGroup : NoiseProgram.GroupArray)
+	{
+		for (const auto& [LayerIndex, Scale] : ProgramGroup.TermArray)
+		{
+			FNoiseProgramLayer& ProgramLayer { NoiseProgram.LayerArray[LayerIndex] };
+			ProgramLayer.MaxAmplitude = FMath::Max(ProgramLayer.MaxAmplitude, FMath::Abs(Scale));
+			
+			LayerIndexMap[LayerIndex] = 0;
+		}
+	}
+
+	TArray<FNoiseProgramLayer> LayerArray;
+
+	for (int32 LayerIndex { 0 }; LayerIndex < NoiseProgram.LayerArray.Num(); ++LayerIndex)
+	{
+		if (LayerIndexMap[LayerIndex] == INDEX_NONE)
+		{
+			continue;
+		}
+
+		LayerIndexMap[LayerIndex] = LayerArray.Num();
+		
+		FNoiseProgramLayer& ProgramLayer { LayerArray.Add_GetRef(NoiseProgram.LayerArray[LayerIndex]) };
+		ProgramLayer.LatticeStep = GetLatticeStep(TerrainConfig, ProgramLayer.Period, ProgramLayer.MaxAmplitude);
+	}
+
+	NoiseProgram.LayerArray = MoveTemp(LayerArray);
+
+	for (FNoiseProgramGroup& ProgramGroup : NoiseProgram.GroupArray)
+	{
+		for (FNoiseProgramTerm& Term : ProgramGroup.TermArray)
+		{
+			Term.LayerIndex = LayerIndexMap[Term.LayerIndex];
+		}
+	}
+
+	return NoiseProgram;
+}
+
+int32 FNoiseProgramCompiler::GetLatticeStep(const UTerrainConfig* TerrainConfig, const float Period, const float Amplitude)
+{
+	if (TerrainConfig->CoarseLayerErrorTolerance <= 0.0f)
+	{
+		return 1;
+	}
+	
+	int32 LatticeStep { 1 };
+
+	while (LatticeStep * 2 <= TerrainConfig->SectorSizeInCells)
+	{
+		const float Spacing { LatticeStep * 2 * TerrainConfig->CellSizeInCentimeters };
+		const float Phase { UE_TWO_PI * Spacing / Period };
+		
+		// Measured bicubic error on Perlin noise stays below Amplitude * Phase^3 / 64
+		if (Amplitude * Phase * Phase * Phase / 64.0f > TerrainConfig->CoarseLayerErrorTolerance)
+		{
+			break;
+		}
+		
+		LatticeStep *= 2;
+	}
+
+	return LatticeStep;
+}
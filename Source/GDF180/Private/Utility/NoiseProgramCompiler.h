@@ -0,0 +1,14 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Data/NoiseProgram.h"
+
+
+class UTerrainConfig;
+
+struct FNoiseProgramCompiler
+{
+	static FNoiseProgram Run(const UTerrainConfig* TerrainConfig);
+	
+	static int32 GetLatticeStep(const UTerrainConfig* TerrainConfig, const float Period, const float Amplitude);
+};
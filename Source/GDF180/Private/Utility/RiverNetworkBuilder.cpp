@@ -0,0 +1,316 @@
+#include "RiverNetworkBuilder.h"
+#include "../Data/TerrainConfig.h"
+#include "Async/ParallelFor.h"
+
+
+const FIntPoint FRiverNetworkBuilder::NeighborOffsetArray[8] {
+	{ -1, -1 }, { 0, -1 }, { 1, -1 },
+	{ -1, 0 }, { 1, 0 },
+	{ -1, 1 }, { 0, 1 }, { 1, 1 }
+};
+
+FRiverNetwork FRiverNetworkBuilder::Run(
+	const FRiverSettings& RiverSettings,
+	const UTerrainConfig* TerrainConfig,
+	const FNoiseProgram& NoiseProgram,
+	const int32 TerrainNoiseGroupIndex
+) {
+	FRiverNetwork RiverNetwork;
+	RiverNetwork.SectorSizeInCells = TerrainConfig->SectorSizeInCells;
+	RiverNetwork.CellSizeInCentimeters = TerrainConfig->CellSizeInCentimeters;
+	RiverNetwork.TileNum = TerrainConfig->WorldSizeInSectors + 1;
+	RiverNetwork.WaterDepth = RiverSettings.WaterDepth;
+	RiverNetwork.BankFalloff = RiverSettings.BankFalloff;
+	
+	const int32 FlowCellSizeInCells { FMath::Max(1, RiverSettings.FlowCellSizeInCells) };
+	const int32 WorldSizeInCells { TerrainConfig->WorldSizeInSectors * TerrainConfig->SectorSizeInCells };
+	
+	const FIntPoint NodeNum { FIntPoint { WorldSizeInCells / FlowCellSizeInCells + 1 } };
+	const float NodeSpacing { FlowCellSizeInCells * TerrainConfig->CellSizeInCentimeters };
+	
+	if (NodeNum.X < 3)
+	{
+		return RiverNetwork;
+	}
+	
+	TArray<float> HeightArray;
+	HeightArray.SetNumUninitialized(NodeNum.X * NodeNum.Y);
+	
+	ParallelFor(
+		NodeNum.Y,
+		[&](const int32 Y)
+		{
+			for (int32 X { 0 }; X < NodeNum.X; ++X)
+			{
+				HeightArray[Y * NodeNum.X + X] = NoiseProgram.SampleGroup(TerrainNoiseGroupIndex, FVector2f { X * NodeSpacing, Y * NodeSpacing });
+			}
+		}
+	);
+	
+	FillDepressions(NodeNum, HeightArray);
+	
+	TArray<int32> ReceiverArray;
+	ComputeReceivers(NodeNum, HeightArray, ReceiverArray);
+	
+	TArray<int32> AccumulationArray;
+	ComputeAccumulation(ReceiverArray, AccumulationArray);
+	
+	// A fraction of the node count keeps river density the same across world sizes and flow cell sizes
+	const int32 MinAccumulation { 
+		FMath::Max(2, FMath::CeilToInt(RiverSettings.MinAccumulationFraction * ReceiverArray.Num())) 
+	};
+	
+	for (int32 NodeIndex { 0 }; NodeIndex < ReceiverArray.Num(); ++NodeIndex)
+	{
+		const int32 ReceiverIndex { ReceiverArray[NodeIndex] };
+		const int32 Accumulation { AccumulationArray[NodeIndex] };
+		
+		if (ReceiverIndex == NodeIndex || Accumulation < MinAccumulation)
+		{
+			continue;
+		}
+		
+		FRiverSegment& Segment { RiverNetwork.SegmentArray.AddDefaulted_GetRef() };
+		Segment.Start = FVector2f { static_cast<float>(NodeIndex % NodeNum.X), static_cast<float>(NodeIndex / NodeNum.X) } * NodeSpacing;
+		Segment.End = FVector2f { static_cast<float>(ReceiverIndex % NodeNum.X), static_cast<float>(ReceiverIndex / NodeNum.X) } * NodeSpacing;
+		
+		// Filled heights never rise downstream, so neither does the bed
+		Segment.StartBedHeight = HeightArray[NodeIndex] - RiverSettings.ChannelDepth;
+		Segment.EndBedHeight = HeightArray[ReceiverIndex] - RiverSettings.ChannelDepth;
+		
+		Segment.HalfWidth = 0.5f * (
+			RiverSettings.MinWidth + 
+			RiverSettings.WidthScale * (FMath::Sqrt(static_cast<float>(Accumulation)) - FMath::Sqrt(static_cast<float>(MinAccumulation)))
+		);
+		
+		const float Reach { Segment.HalfWidth + RiverSettings.BankFalloff };
+		
+		Segment.Bounds = FBox2f { Segment.Start.ComponentMin(Segment.End) - Reach, Segment.Start.ComponentMax(Segment.End) + Reach };
+	}
+	
+	BuildTileIndex(RiverNetwork);
+	
+	return RiverNetwork;
+}
+
+void FRiverNetworkBuilder::FillDepressions(const FIntPoint NodeNum, TArray<float>& HeightArray)
+{
+	// Priority flood from the world edge: every node ends up at least as high as the lowest path out of the world
+	using FOpenNode = TPair<float, int32>;
+	
+	auto IsLower = [](const FOpenNode& A, const FOpenNode& B)
+	{
+		return A.Key < B.Key || (A.Key == B.Key && A.Value < B.Value);
+	};
+	
+	TArray<bool> ClosedArray;
+	ClosedArray.SetNumZeroed(HeightArray.Num());
+	
+	TArray<FOpenNode> OpenHeap;
+	OpenHeap.Reserve(4 * NodeNum.X);
+	
+	for (int32 Y { 0 }; Y < NodeNum.Y; ++Y)
+	{
+		for (int32 X { 0 }; X < NodeNum.X; ++X)
+		{
+			if (X == 0 || Y == 0 || X == NodeNum.X - 1 || Y == NodeNum.Y - 1)
+			{
+				const int32 NodeIndex { Y * NodeNum.X + X };
+				
+				ClosedArray[NodeIndex] = true;
+				OpenHeap.HeapPush({ HeightArray[NodeIndex], NodeIndex }, IsLower);
+			}
+		}
+	}
+	
+	while (!OpenHeap.IsEmpty())
+	{
+		FOpenNode OpenNode;
+		OpenHeap.HeapPop(OpenNode, IsLower, EAllowShrinking::No);
+		
+		const FIntPoint Node { OpenNode.Value % NodeNum.X, OpenNode.Value / NodeNum.X };
+		
+		for (const FIntPoint& NeighborOffset : NeighborOffsetArray)
+		{
+			const FIntPoint Neighbor { Node + NeighborOffset };
+			
+			if (Neighbor.X < 0 || Neighbor.Y < 0 || Neighbor.X >= NodeNum.X || Neighbor.Y >= NodeNum.Y)
+			{
+				continue;
+			}
+			
+			const int32 NeighborIndex { Neighbor.Y * NodeNum.X + Neighbor.X };
+			
+			if (ClosedArray[NeighborIndex])
+			{
+				continue;
+			}
+			
+			ClosedArray[NeighborIndex] = true;
+			
+			HeightArray[NeighborIndex] = FMath::Max(HeightArray[NeighborIndex], OpenNode.Key + FillEpsilon);
+			OpenHeap.HeapPush({ HeightArray[NeighborIndex], NeighborIndex }, IsLower);
+		}
+	}
+}
+
+void FRiverNetworkBuilder::ComputeReceivers(const FIntPoint NodeNum, const TArray<float>& HeightArray, TArray<int32>& ReceiverArray)
+{
+	ReceiverArray.SetNumUninitialized(HeightArray.Num());
+	
+	ParallelFor(
+		NodeNum.Y,
+		[&](const int32 Y)
+		{
+			for (int32 X { 0 }; X < NodeNum.X; ++X)
+			{
+				const int32 NodeIndex { Y * NodeNum.X + X };
+				
+				// Edge nodes drain out of the world
+				int32 ReceiverIndex { NodeIndex };
+				
+				if (X > 0 && Y > 0 && X < NodeNum.X - 1 && Y < NodeNum.Y - 1)
+				{
+					float MaxSlope { 0.0f };
+					
+					for (const FIntPoint& NeighborOffset : NeighborOffsetArray)
+					{
+						const int32 NeighborIndex { (Y + NeighborOffset.Y) * NodeNum.X + X + NeighborOffset.X };
+						
+						const float Drop { HeightArray[NodeIndex] - HeightArray[NeighborIndex] };
+						const float Slope { NeighborOffset.X != 0 && NeighborOffset.Y != 0 ? Drop * UE_INV_SQRT_2 : Drop };
+						
+						if (Slope > MaxSlope)
+						{
+							MaxSlope = Slope;
+							ReceiverIndex = NeighborIndex;
+						}
+					}
+				}
+				
+				ReceiverArray[NodeIndex] = ReceiverIndex;
+			}
+		}
+	);
+}
+
+void FRiverNetworkBuilder::ComputeAccumulation(const TArray<int32>& ReceiverArray, TArray<int32>& AccumulationArray)
+{
+	const int32 NodeNum { ReceiverArray.Num() };
+	
+	TArray<int32> DonorNumArray;
+	DonorNumArray.SetNumZeroed(NodeNum);
+	
+	AccumulationArray.Init(1, NodeNum);
+	
+	ParallelFor(
+		NodeNum,
+		[&](const int32 NodeIndex)
+		{
+			if (const int32 ReceiverIndex { ReceiverArray[NodeIndex] }; ReceiverIndex != NodeIndex)
+			{
+				FPlatformAtomics::InterlockedIncrement(&DonorNumArray[ReceiverIndex]);
+			}
+		}
+	);
+	
+	TArray<int32> FrontierArray;
+	TArray<int32> NextFrontierArray;
+	
+	FrontierArray.Reserve(NodeNum);
+	NextFrontierArray.SetNumUninitialized(NodeNum);
+	
+	for (int32 NodeIndex { 0 }; NodeIndex < NodeNum; ++NodeIndex)
+	{
+		if (DonorNumArray[NodeIndex] == 0)
+		{
+			FrontierArray.Add(NodeIndex);
+		}
+	}
+	
+	// Nodes whose donors are all counted push their total downstream together; integer sums keep any order exact
+	while (!FrontierArray.IsEmpty())
+	{
+		int32 NextFrontierNum { 0 };
+		
+		ParallelFor(
+			TEXT("RiverAccumulation.PF"),
+			FrontierArray.Num(),
+			1024,
+			[&](const int32 FrontierIndex)
+			{
+				const int32 NodeIndex { FrontierArray[FrontierIndex] };
+				const int32 ReceiverIndex { ReceiverArray[NodeIndex] };
+				
+				if (ReceiverIndex == NodeIndex)
+				{
+					return;
+				}
+				
+				FPlatformAtomics::InterlockedAdd(&AccumulationArray[ReceiverIndex], AccumulationArray[NodeIndex]);
+				
+				if (FPlatformAtomics::InterlockedDecrement(&DonorNumArray[ReceiverIndex]) == 0)
+				{
+					NextFrontierArray[FPlatformAtomics::InterlockedIncrement(&NextFrontierNum) - 1] = ReceiverIndex;
+				}
+			}
+		);
+		
+		FrontierArray.Reset();
+		FrontierArray.Append(NextFrontierArray.GetData(), NextFrontierNum);
+	}
+}
+
+void FRiverNetworkBuilder::BuildTileIndex(FRiverNetwork& RiverNetwork)
+{
+	const int32 TileNum { RiverNetwork.TileNum };
+	const float TileSizeInCentimeters { RiverNetwork.SectorSizeInCells * RiverNetwork.CellSizeInCentimeters };
+	
+	auto GetTileRect = [&](const FRiverSegment& Segment)
+	{
+		return FIntRect {
+			FMath::Clamp(FMath::FloorToInt(Segment.Bounds.Min.X / TileSizeInCentimeters), 0, TileNum - 1),
+			FMath::Clamp(FMath::FloorToInt(Segment.Bounds.Min.Y / TileSizeInCentimeters), 0, TileNum - 1),
+			FMath::Clamp(FMath::FloorToInt(Segment.Bounds.Max.X / TileSizeInCentimeters), 0, TileNum - 1),
+			FMath::Clamp(FMath::FloorToInt(Segment.Bounds.Max.Y / TileSizeInCentimeters), 0, TileNum - 1)
+		};
+	};
+	
+	TArray<int32>& TileOffsetArray { RiverNetwork.TileOffsetArray };
+	TileOffsetArray.SetNumZeroed(TileNum * TileNum + 1);
+	
+	for (const FRiverSegment& Segment : RiverNetwork.SegmentArray)
+	{
+		const FIntRect TileRect { GetTileRect(Segment) };
+		
+		for (int32 Y { TileRect.Min.Y }; Y <= TileRect.Max.Y; ++Y)
+		{
+			for (int32 X { TileRect.Min.X }; X <= TileRect.Max.X; ++X)
+			{
+				++TileOffsetArray[Y * TileNum + X + 1];
+			}
+		}
+	}
+	
+	for (int32 TileIndex { 0 }; TileIndex < TileNum * TileNum; ++TileIndex)
+	{
+		TileOffsetArray[TileIndex + 1] += TileOffsetArray[TileIndex];
+	}
+	
+	TArray<int32> TileFillArray { TileOffsetArray };
+	
+	RiverNetwork.SegmentIndexArray.SetNumUninitialized(TileOffsetArray.Last());
+	
+	for (int32 SegmentIndex { 0 }; SegmentIndex < RiverNetwork.SegmentArray.Num(); ++SegmentIndex)
+	{
+		const FIntRect TileRect { GetTileRect(RiverNetwork.SegmentArray[SegmentIndex]) };
+		
+		for (int32 Y { TileRect.Min.Y }; Y <= TileRect.Max.Y; ++Y)
+		{
+			for (int32 X { TileRect.Min.X }; X <= TileRect.Max.X; ++X)
+			{
+				RiverNetwork.SegmentIndexArray[TileFillArray[Y * TileNum + X]++] = SegmentIndex;
+			}
+		}
+	}
+}
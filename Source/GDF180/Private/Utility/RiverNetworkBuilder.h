@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Data/NoiseProgram.h"
+#include "../Data/RiverNetwork.h"
+#include "../Data/RiverSettings.h"
+
+
+class UTerrainConfig;
+
+struct FRiverNetworkBuilder
+{
+	// Routes flow over a coarse grid spanning the world and keeps the paths that drain enough upstream area
+	static FRiverNetwork Run(
+		const FRiverSettings& RiverSettings,
+		const UTerrainConfig* TerrainConfig,
+		const FNoiseProgram& NoiseProgram,
+		const int32 TerrainNoiseGroupIndex
+	);
+
+private:
+	// Height step added across flats and filled pits so every node keeps a strictly lower neighbor
+	static constexpr float FillEpsilon { 0.01f };
+	
+	static const FIntPoint NeighborOffsetArray[8];
+	
+	static void FillDepressions(const FIntPoint NodeNum, TArray<float>& HeightArray);
+	
+	static void ComputeReceivers(const FIntPoint NodeNum, const TArray<float>& HeightArray, TArray<int32>& ReceiverArray);
+	
+	static void ComputeAccumulation(const TArray<int32>& ReceiverArray, TArray<int32>& AccumulationArray);
+	
+	static void BuildTileIndex(FRiverNetwork& RiverNetwork);
+};
@@ -0,0 +1,234 @@
+#include "ScatterSampler.h"
+#include "Async/ParallelFor.h"
+
+
+void FScatterSampler::Run(
+	const TConstArrayView<FBiomeDefinition> BiomeDefinitionArray,
+	const TConstArrayView<TPair<uint8, int32>> ScatterRuleArray,
+	const int32 Seed,
+	const FTerrainSampleRegion& Region,
+	const TArray<float>& TerrainHeightArray,
+	const TArray<float>* WaterHeightArray,
+	const FIntRect& SectorRectInCells,
+	const float CellSizeInCentimeters,
+	FSectorScatterData& ScatterData
+) {
+	ScatterData.Reset(ScatterRuleArray.Num());
+	
+	const FVector2f SectorMin { FVector2f { SectorRectInCells.Min } * CellSizeInCentimeters };
+	const FVector2f SectorMax { FVector2f { SectorRectInCells.Max } * CellSizeInCentimeters };
+
+	ParallelFor(
+		ScatterRuleArray.Num(),
+		[&](const int32 ScatterRuleIndex)
+		{
+			const auto& [BiomeIndex, RuleIndex] { ScatterRuleArray[ScatterRuleIndex] };
+			
+			const FScatterRule& ScatterRule { BiomeDefinitionArray[BiomeIndex].ScatterRuleArray[RuleIndex] };
+			
+			if (!ScatterRule.Mesh || ScatterRule.MinSpacing <= 0.0f || ScatterRule.Density <= 0.0f)
+			{
+				return;
+			}
+			
+			TArray<FTransform>& TransformArray { ScatterData.RuleTransformArrays[ScatterRuleIndex] };
+			
+			// At most one candidate per grid cell, and every candidate within MinSpacing lies in the surrounding 5x5 cells
+			const float GridCellSize { ScatterRule.MinSpacing / UE_SQRT_2 };
+			
+			const FIntPoint GridMin { 
+				FMath::FloorToInt(SectorMin.X / GridCellSize), 
+				FMath::FloorToInt(SectorMin.Y / GridCellSize) 
+			};
+			
+			const FIntPoint GridMax { 
+				FMath::FloorToInt(SectorMax.X / GridCellSize), 
+				FMath::FloorToInt(SectorMax.Y / GridCellSize) 
+			};
+			
+			const float MinNormalZ { FMath::Cos(FMath::DegreesToRadians(ScatterRule.MaxSlopeDegrees)) };
+			
+			for (int32 GridY { GridMin.Y }; GridY <= GridMax.Y; ++GridY)
+			{
+				for (int32 GridX { GridMin.X }; GridX <= GridMax.X; ++GridX)
+				{
+					const FIntPoint GridCoordinates { GridX, GridY };
+					
+					const FCandidate Candidate { 
+						MakeCandidate(Seed, BiomeIndex, RuleIndex, GridCoordinates, GridCellSize, ScatterRule.Density) 
+					};
+					
+					// Half-open sector bounds give each candidate to exactly one sector
+					if (
+						!Candidate.bActive ||
+						Candidate.Position.X < SectorMin.X || Candidate.Position.X >= SectorMax.X ||
+						Candidate.Position.Y < SectorMin.Y || Candidate.Position.Y >= SectorMax.Y ||
+						!IsDiskWinner(Candidate, Seed, BiomeIndex, RuleIndex, GridCoordinates, GridCellSize, ScatterRule)
+					) {
+						continue;
+					}
+					
+					const FVector2f RegionPosition { 
+						Candidate.Position / CellSizeInCentimeters - FVector2f { Region.OriginInCells } 
+					};
+					
+					const FIntPoint Cell {
+						FMath::Clamp(FMath::FloorToInt(RegionPosition.X), 0, Region.SizeInCells.X - 1),
+						FMath::Clamp(FMath::FloorToInt(RegionPosition.Y), 0, Region.SizeInCells.Y - 1)
+					};
+					
+					if (Region.CellBiomeIndexArray[Region.GetCellIndex(Cell)] != BiomeIndex)
+					{
+						continue;
+					}
+					
+					const FVector2f Alpha { RegionPosition - FVector2f { Cell } };
+					
+					auto SampleBilinear = [&](const TArray<float>& HeightArray)
+					{
+						return FMath::BiLerp(
+							HeightArray[Region.GetVertexIndex(Cell)],
+							HeightArray[Region.GetVertexIndex(Cell + FIntPoint { 1, 0 })],
+							HeightArray[Region.GetVertexIndex(Cell + FIntPoint { 0, 1 })],
+							HeightArray[Region.GetVertexIndex(Cell + FIntPoint { 1, 1 })],
+							Alpha.X,
+							Alpha.Y
+						);
+					};
+					
+					const float Height { SampleBilinear(TerrainHeightArray) };
+					
+					if (!ScatterRule.bAllowUnderwater && Height < (WaterHeightArray ? SampleBilinear(*WaterHeightArray) : 0.0f))
+					{
+						continue;
+					}
+					
+					const float H00 { TerrainHeightArray[Region.GetVertexIndex(Cell)] };
+					const float H10 { TerrainHeightArray[Region.GetVertexIndex(Cell + FIntPoint { 1, 0 })] };
+					const float H01 { TerrainHeightArray[Region.GetVertexIndex(Cell + FIntPoint { 0, 1 })] };
+					const float H11 { TerrainHeightArray[Region.GetVertexIndex(Cell + FIntPoint { 1, 1 })] };
+					
+					const FVector Normal { 
+						FVector {
+							-FMath::Lerp(H10 - H00, H11 - H01, Alpha.Y) / CellSizeInCentimeters,
+							-FMath::Lerp(H01 - H00, H11 - H10, Alpha.X) / CellSizeInCentimeters,
+							1.0f
+						}.GetSafeNormal()
+					};
+					
+					if (Normal.Z < MinNormalZ)
+					{
+						continue;
+					}
+					
+					// Instance attributes come from the candidate's own hash, so they never depend on thread or sector order
+					FRandomStream RandomStream { static_cast<int32>(MurmurFinalize32(Candidate.Priority)) };
+					
+					const FQuat YawRotation { FVector::UpVector, RandomStream.FRandRange(0.0f, UE_TWO_PI) };
+					
+					const FQuat Rotation { 
+						ScatterRule.bAlignToSurface 
+							? FQuat::FindBetweenNormals(FVector::UpVector, Normal) * YawRotation 
+							: YawRotation 
+					};
+					
+					const FVector Location {
+						Candidate.Position.X - SectorMin.X,
+						Candidate.Position.Y - SectorMin.Y,
+						Height
+					};
+					
+					TransformArray.Emplace(
+						Rotation, 
+						Location, 
+						FVector { RandomStream.FRandRange(ScatterRule.MinScale, ScatterRule.MaxScale) }
+					);
+				}
+			}
+		},
+		ScatterRuleArray.Num() > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread
+	);
+}
+
+uint32 FScatterSampler::HashGridCell(
+	const int32 Seed, 
+	const int32 BiomeIndex, 
+	const int32 RuleIndex, 
+	const FIntPoint GridCoordinates
+) {
+	uint32 Hash { MurmurFinalize32(static_cast<uint32>(Seed)) };
+	
+	// Keyed by the rule's place within its biome, so rules added to other biomes leave its placements alone
+	for (const int32 Value : { BiomeIndex, RuleIndex, GridCoordinates.X, GridCoordinates.Y })
+	{
+		Hash = MurmurFinalize32(Hash ^ (static_cast<uint32>(Value) * 0x9E3779B1u));
+	}
+	
+	return Hash;
+}
+
+FScatterSampler::FCandidate FScatterSampler::MakeCandidate(
+	const int32 Seed, 
+	const int32 BiomeIndex, 
+	const int32 RuleIndex, 
+	const FIntPoint GridCoordinates, 
+	const float GridCellSize, 
+	const float Density
+) {
+	const uint32 Hash { HashGridCell(Seed, BiomeIndex, RuleIndex, GridCoordinates) };
+	
+	FRandomStream RandomStream { static_cast<int32>(Hash) };
+	
+	FCandidate Candidate;
+	Candidate.Position = (FVector2f { GridCoordinates } + FVector2f { RandomStream.GetFraction(), RandomStream.GetFraction() }) * GridCellSize;
+	Candidate.bActive = RandomStream.GetFraction() < Density;
+	Candidate.Priority = Hash;
+	
+	return Candidate;
+}
+
+bool FScatterSampler::IsDiskWinner(
+	const FCandidate& Candidate,
+	const int32 Seed, 
+	const int32 BiomeIndex, 
+	const int32 RuleIndex, 
+	const FIntPoint GridCoordinates, 
+	const float GridCellSize, 
+	const FScatterRule& ScatterRule
+) {
+	// A candidate survives when it outranks every active candidate within the disk, which needs only hashes and
+	// not the neighboring sectors' data, so adjacent sectors agree on their shared border
+	for (int32 OffsetY { -2 }; OffsetY <= 2; ++OffsetY)
+	{
+		for (int32 OffsetX { -2 }; OffsetX <= 2; ++OffsetX)
+		{
+			if (OffsetX == 0 && OffsetY == 0)
+			{
+				continue;
+			}
+			
+			const FIntPoint NeighborGridCoordinates { GridCoordinates + FIntPoint { OffsetX, OffsetY } };
+			
+			const FCandidate Neighbor { 
+				MakeCandidate(Seed, BiomeIndex, RuleIndex, NeighborGridCoordinates, GridCellSize, ScatterRule.Density) 
+			};
+			
+			if (!Neighbor.bActive || FVector2f::DistSquared(Neighbor.Position, Candidate.Position) >= FMath::Square(ScatterRule.MinSpacing))
+			{
+				continue;
+			}
+			
+			const bool bNeighborWins { 
+				Neighbor.Priority > Candidate.Priority || 
+				(Neighbor.Priority == Candidate.Priority && (OffsetY > 0 || (OffsetY == 0 && OffsetX > 0))) 
+			};
+			
+			if (bNeighborWins)
+			{
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Data/BiomeDefinition.h"
+#include "../Data/SectorScatterData.h"
+#include "../Data/TerrainSampleRegion.h"
+
+
+struct FScatterSampler
+{
+	// Places every rule's instances inside one sector of a sampled region, each rule on its own worker
+	static void Run(
+		const TConstArrayView<FBiomeDefinition> BiomeDefinitionArray,
+		const TConstArrayView<TPair<uint8, int32>> ScatterRuleArray,
+		const int32 Seed,
+		const FTerrainSampleRegion& Region,
+		const TArray<float>& TerrainHeightArray,
+		const TArray<float>* WaterHeightArray, // Null without a water group
+		const FIntRect& SectorRectInCells,
+		const float CellSizeInCentimeters,
+		FSectorScatterData& ScatterData
+	);
+
+private:
+	struct FCandidate
+	{
+		FVector2f Position;
+		uint32 Priority;
+		bool bActive;
+	};
+	
+	static uint32 HashGridCell(const int32 Seed, const int32 BiomeIndex, const int32 RuleIndex, const FIntPoint GridCoordinates);
+	
+	static FCandidate MakeCandidate(
+		const int32 Seed, 
+		const int32 BiomeIndex, 
+		const int32 RuleIndex, 
+		const FIntPoint GridCoordinates, 
+		const float GridCellSize, 
+		const float Density
+	);
+	
+	static bool IsDiskWinner(
+		const FCandidate& Candidate,
+		const int32 Seed, 
+		const int32 BiomeIndex, 
+		const int32 RuleIndex, 
+		const FIntPoint GridCoordinates, 
+		const float GridCellSize, 
+		const FScatterRule& ScatterRule
+	);
+};
@@ -1,8 +1,14 @@
 #include "StaticMeshConstructor.h"
 #include "Engine/StaticMesh.h"
 #include "PhysicsEngine/BodySetup.h"
+#include "StaticMeshResources.h"
+#include "Async/ParallelFor.h"
+#include "../Data/SectorRenderData.h"
+
+#if WITH_EDITOR
 #include "StaticMeshAttributes.h"
 #include "MeshDescription.h"
+#endif
 
 
 TObjectPtr<UStaticMesh> FStaticMeshConstructor::Run(
@@ -11,15 +17,204 @@ TObjectPtr<UStaticMesh> FStaticMeshConstructor::Run(
     const FMeshRenderData& MeshRenderData,
     const bool bGenerateCollision
 ) {
-    TObjectPtr<UStaticMesh> StaticMesh {
-        NewObject<UStaticMesh>(
-            Outer,
-            MeshName,
-            RF_Public | RF_Standalone
-        )
-    };
+    TObjectPtr<UStaticMesh> StaticMesh { CreateStaticMesh(Outer, MeshName) };
+
+    const int32 VertexNum { MeshRenderData.VertexArray.Num() };
+    const int32 IndexNum { MeshRenderData.IndexArray.Num() };
+
+    // Area-weighted face normals, accumulated per vertex
+    TArray<FVector3f> NormalArray;
+    NormalArray.SetNumZeroed(VertexNum);
+
+    for (int32 Index { 0 }; Index < IndexNum; Index += 3)
+    {
+        const uint32 Vertex0Index { MeshRenderData.IndexArray[Index + 0] };
+        const uint32 Vertex1Index { MeshRenderData.IndexArray[Index + 1] };
+        const uint32 Vertex2Index { MeshRenderData.IndexArray[Index + 2] };
+
+        const FVector3f& Position0 { MeshRenderData.VertexArray[Vertex0Index] };
+
+        const FVector3f FaceNormal {
+            FVector3f::CrossProduct(
+                MeshRenderData.VertexArray[Vertex2Index] - Position0,
+                MeshRenderData.VertexArray[Vertex1Index] - Position0
+            )
+        };
+
+        NormalArray[Vertex0Index] += FaceNormal;
+        NormalArray[Vertex1Index] += FaceNormal;
+        NormalArray[Vertex2Index] += FaceNormal;
+    }
+
+    // Geometry goes straight into the LOD's final vertex and index buffers, with no source model to rebuild from
+    StaticMesh->SetRenderData(MakeUnique<FStaticMeshRenderData>());
+
+    FStaticMeshRenderData* StaticMeshRenderData { StaticMesh->GetRenderData() };
+    StaticMeshRenderData->AllocateLODResources(1);
+    StaticMeshRenderData->ScreenSize[0].Default = 1.0f;
+
+    FStaticMeshLODResources& LODResources { StaticMeshRenderData->LODResources[0] };
+    LODResources.bHasColorVertexData = true;
+
+    FStaticMeshVertexBuffers& VertexBuffers { LODResources.VertexBuffers };
+    VertexBuffers.PositionVertexBuffer.Init(MeshRenderData.VertexArray, bGenerateCollision);
+    VertexBuffers.StaticMeshVertexBuffer.SetUseFullPrecisionUVs(true);
+    VertexBuffers.StaticMeshVertexBuffer.SetUseHighPrecisionTangentBasis(true);
+    VertexBuffers.StaticMeshVertexBuffer.Init(VertexNum, 1);
+    VertexBuffers.ColorVertexBuffer.Init(VertexNum);
+
+    FBox3f Bounds { ForceInit };
+
+    for (int32 Index { 0 }; Index < VertexNum; Index++)
+    {
+        const FVector3f Normal { NormalArray[Index].GetSafeNormal(UE_SMALL_NUMBER, FVector3f::UpVector) };
+
+        // Forward is nearly parallel to a normal along X, so project Right instead
+        const FVector3f TangentX {
+            FMath::Abs(Normal.X) < 0.99f
+                ? (FVector3f::ForwardVector - Normal * Normal.X).GetSafeNormal()
+                : (FVector3f::RightVector - Normal * Normal.Y).GetSafeNormal()
+        };
+
+        const FVector3f TangentY { FVector3f::CrossProduct(Normal, TangentX) };
+
+        VertexBuffers.StaticMeshVertexBuffer.SetVertexTangents(Index, TangentX, TangentY, Normal);
+        VertexBuffers.StaticMeshVertexBuffer.SetVertexUV(Index, 0, MeshRenderData.UVArray[Index]);
+        VertexBuffers.ColorVertexBuffer.VertexColor(Index) = FLinearColor { MeshRenderData.VertexColorArray[Index] }.ToFColor(true);
+
+        Bounds += MeshRenderData.VertexArray[Index];
+    }
+
+    LODResources.IndexBuffer.SetIndices(MeshRenderData.IndexArray, EIndexBufferStride::Force32Bit);
+
+    FStaticMeshSection& Section { LODResources.Sections.AddDefaulted_GetRef() };
+    Section.MaterialIndex = 0;
+    Section.FirstIndex = 0;
+    Section.NumTriangles = IndexNum / 3;
+    Section.MinVertexIndex = 0;
+    Section.MaxVertexIndex = FMath::Max(0, VertexNum - 1);
+    Section.bEnableCollision = bGenerateCollision;
+    Section.bCastShadow = true;
+
+    StaticMeshRenderData->Bounds = FBoxSphereBounds { FBox { Bounds } };
+
+    StaticMesh->bAllowCPUAccess = bGenerateCollision;
+    StaticMesh->CalculateExtendedBounds();
+    StaticMesh->InitResources();
+
+    if (bGenerateCollision)
+    {
+        SetupCollision(StaticMesh);
+    }
+
+    return StaticMesh;
+}
+
+#if WITH_EDITOR
+TObjectPtr<UStaticMesh> FStaticMeshConstructor::RunFromMeshDescription(
+    UObject* Outer,
+    const TCHAR* MeshName,
+    const FMeshRenderData& MeshRenderData,
+    const bool bGenerateCollision
+) {
+    TObjectPtr<UStaticMesh> StaticMesh { CreateStaticMesh(Outer, MeshName) };
 
     FMeshDescription MeshDescription;
+    BuildMeshDescription(MeshRenderData, MeshDescription);
+    
+    SetupSourceModel(StaticMesh, MoveTemp(MeshDescription));
+    
+    StaticMesh->Build(false);
+    
+    FinishBuild(StaticMesh, bGenerateCollision);
+
+    return StaticMesh;
+}
+
+void FStaticMeshConstructor::RunBatchFromMeshDescription(
+    UObject* Outer,
+    const TConstArrayView<const FSectorRenderData*> SectorRenderDataArray,
+    TFunction<void(const FIntPoint SectorCoordinates, const FSectorMeshes& SectorMeshes)> OnSectorBuilt
+) {
+    // Ground and water meshes alternate, two per sector
+    const int32 MeshNum { 2 * SectorRenderDataArray.Num() };
+
+    auto GetMeshRenderData = [&](const int32 MeshIndex) -> const FMeshRenderData&
+    {
+        const FSectorRenderData& SectorRenderData { *SectorRenderDataArray[MeshIndex / 2] };
+        
+        return MeshIndex % 2 == 0 ? SectorRenderData.GetGroundMeshRenderData() : SectorRenderData.WaterMeshRenderData;
+    };
+
+    // Descriptions are plain data, so they are filled across workers before any mesh object takes one
+    TArray<FMeshDescription> MeshDescriptionArray;
+    MeshDescriptionArray.SetNum(MeshNum);
+
+    ParallelFor(
+        MeshNum,
+        [&](const int32 MeshIndex)
+        {
+            BuildMeshDescription(GetMeshRenderData(MeshIndex), MeshDescriptionArray[MeshIndex]);
+        }
+    );
+
+    TArray<UStaticMesh*> StaticMeshArray;
+    StaticMeshArray.Reserve(MeshNum);
+
+    for (int32 MeshIndex { 0 }; MeshIndex < MeshNum; MeshIndex++)
+    {
+        const FIntPoint SectorCoordinates { SectorRenderDataArray[MeshIndex / 2]->SectorCoordinates };
+
+        const FString MeshName {
+            FString::Printf(TEXT("%s_%d_%d"), MeshIndex % 2 == 0 ? TEXT("SMG") : TEXT("SMW"), SectorCoordinates.X, SectorCoordinates.Y)
+        };
+
+        UStaticMesh* StaticMesh { CreateStaticMesh(Outer, *MeshName) };
+        
+        SetupSourceModel(StaticMesh, MoveTemp(MeshDescriptionArray[MeshIndex]));
+
+        StaticMeshArray.Add(StaticMesh);
+    }
+
+    const TSharedRef<TFunction<void(const FIntPoint, const FSectorMeshes&)>> SharedOnSectorBuilt {
+        MakeShared<TFunction<void(const FIntPoint, const FSectorMeshes&)>>(MoveTemp(OnSectorBuilt))
+    };
+
+    for (int32 SectorIndex { 0 }; SectorIndex < SectorRenderDataArray.Num(); SectorIndex++)
+    {
+        const FSectorMeshes SectorMeshes { StaticMeshArray[2 * SectorIndex], StaticMeshArray[2 * SectorIndex + 1] };
+        
+        const FIntPoint SectorCoordinates { SectorRenderDataArray[SectorIndex]->SectorCoordinates };
+        
+        const TSharedRef<int32> RemainingMeshNum { MakeShared<int32>(2) };
+
+        for (UStaticMesh* StaticMesh : { SectorMeshes.GroundStaticMesh.Get(), SectorMeshes.WaterStaticMesh.Get() })
+        {
+            const bool bGenerateCollision { StaticMesh == SectorMeshes.GroundStaticMesh };
+
+            StaticMesh->OnPostMeshBuild().AddWeakLambda(
+                Outer,
+                [Outer, SectorCoordinates, SectorMeshes, RemainingMeshNum, SharedOnSectorBuilt, bGenerateCollision](UStaticMesh* BuiltStaticMesh)
+                {
+                    BuiltStaticMesh->OnPostMeshBuild().RemoveAll(Outer);
+
+                    FinishBuild(BuiltStaticMesh, bGenerateCollision);
+
+                    if (--*RemainingMeshNum == 0)
+                    {
+                        (*SharedOnSectorBuilt)(SectorCoordinates, SectorMeshes);
+                    }
+                }
+            );
+        }
+    }
+
+    // Builds run concurrently through the static mesh compiler, each mesh reporting back as it finishes
+    UStaticMesh::BatchBuild(StaticMeshArray, true);
+}
+
+void FStaticMeshConstructor::BuildMeshDescription(const FMeshRenderData& MeshRenderData, FMeshDescription& MeshDescription)
+{
     FStaticMeshAttributes Attributes { MeshDescription };
     
     Attributes.Register();
@@ -29,76 +224,38 @@ TObjectPtr<UStaticMesh> FStaticMeshConstructor::Run(
     MeshDescription.ReserveNewVertexInstances(MeshRenderData.IndexArray.Num());
     MeshDescription.ReserveNewPolygons(MeshRenderData.IndexArray.Num() / 3);
 
-    TMap<int32, FVertexID> VertexMap;
-    VertexMap.Reserve(MeshRenderData.VertexArray.Num());
-
+    // Vertices are created in order, so a render data index is also its FVertexID
     for (int32 Index { 0 }; Index < MeshRenderData.VertexArray.Num(); Index++)
     {
-        FVertexID VertexID { MeshDescription.CreateVertex() };
-        
-        Attributes.GetVertexPositions()[VertexID] = MeshRenderData.VertexArray[Index];
-
-        VertexMap.Add(Index, VertexID);
+        Attributes.GetVertexPositions()[MeshDescription.CreateVertex()] = MeshRenderData.VertexArray[Index];
     }
     
     const FPolygonGroupID PolygonGroup { MeshDescription.CreatePolygonGroup() };
 
     for (int32 Index { 0 }; Index < MeshRenderData.IndexArray.Num(); Index += 3)
     {
-        const int32 Vertex0Index { MeshRenderData.IndexArray[Index + 0] }; 
-        const int32 Vertex1Index { MeshRenderData.IndexArray[Index + 1] }; 
-        const int32 Vertex2Index { MeshRenderData.IndexArray[Index + 2] }; 
-        
-        const FVertexInstanceID VertexInstanceID0 { MeshDescription.CreateVertexInstance(VertexMap[Vertex0Index]) };
-        const FVertexInstanceID VertexInstanceID1 { MeshDescription.CreateVertexInstance(VertexMap[Vertex1Index]) };
-        const FVertexInstanceID VertexInstanceID2 { MeshDescription.CreateVertexInstance(VertexMap[Vertex2Index]) };
-        
-        Attributes.GetVertexInstanceUVs().Set(
-            VertexInstanceID0, 
-            0, 
-            MeshRenderData.UVArray[Vertex0Index]
-        );
-        
-        Attributes.GetVertexInstanceUVs().Set(
-            VertexInstanceID1, 
-            0, 
-            MeshRenderData.UVArray[Vertex1Index]
-        );
-        
-        Attributes.GetVertexInstanceUVs().Set(
-            VertexInstanceID2, 
-            0, 
-            MeshRenderData.UVArray[Vertex2Index]
-        );
-        
-        Attributes.GetVertexInstanceColors().Set(
-            VertexInstanceID0, 
-            MeshRenderData.VertexColorArray[Vertex0Index]
-        );
-        
-        Attributes.GetVertexInstanceColors().Set(
-            VertexInstanceID1, 
-            MeshRenderData.VertexColorArray[Vertex1Index]
-        );
-        
-        Attributes.GetVertexInstanceColors().Set(
-            VertexInstanceID2, 
-            MeshRenderData.VertexColorArray[Vertex2Index]
-        );
+        TArray<FVertexInstanceID, TFixedAllocator<3>> InstanceArray;
+
+        for (int32 Corner { 0 }; Corner < 3; Corner++)
+        {
+            const int32 VertexIndex { static_cast<int32>(MeshRenderData.IndexArray[Index + Corner]) };
+
+            const FVertexInstanceID VertexInstanceID { MeshDescription.CreateVertexInstance(FVertexID { VertexIndex }) };
+
+            Attributes.GetVertexInstanceUVs().Set(VertexInstanceID, 0, MeshRenderData.UVArray[VertexIndex]);
+            Attributes.GetVertexInstanceColors().Set(VertexInstanceID, MeshRenderData.VertexColorArray[VertexIndex]);
 
-        TArray InstanceArray { VertexInstanceID0, VertexInstanceID1, VertexInstanceID2 };
+            InstanceArray.Add(VertexInstanceID);
+        }
         
         MeshDescription.CreatePolygon(PolygonGroup, InstanceArray);
     }
+}
 
+void FStaticMeshConstructor::SetupSourceModel(UStaticMesh* StaticMesh, FMeshDescription&& MeshDescription)
+{
     StaticMesh->SetLightingGuid(FGuid::NewGuid());
     StaticMesh->SetNumSourceModels(1);
-
-    if (StaticMesh->GetStaticMaterials().Num() == 0)
-    {
-        UMaterialInterface* DefaultMat { UMaterial::GetDefaultMaterial(MD_Surface) };
-        StaticMesh->AddMaterial(DefaultMat);
-    }
     
     FStaticMeshSourceModel& SourceModel { StaticMesh->GetSourceModel(0) };
     SourceModel.BuildSettings.bRecomputeNormals = true;
@@ -110,21 +267,47 @@ TObjectPtr<UStaticMesh> FStaticMeshConstructor::Run(
     StaticMesh->CreateMeshDescription(0, MoveTemp(MeshDescription));
     StaticMesh->CommitMeshDescription(0);
     StaticMesh->ImportVersion = LastVersion;
-    StaticMesh->Build(false);
+}
+
+void FStaticMeshConstructor::FinishBuild(UStaticMesh* StaticMesh, const bool bGenerateCollision)
+{
     StaticMesh->PostEditChange();
 
     if (bGenerateCollision)
     {
-        StaticMesh->bAllowCPUAccess = true;
-
-        StaticMesh->CreateBodySetup();
-        StaticMesh->GetBodySetup()->CollisionTraceFlag = CTF_UseComplexAsSimple;
-        StaticMesh->GetBodySetup()->bMeshCollideAll = true;
-        StaticMesh->GetBodySetup()->bHasCookedCollisionData = true;
-        StaticMesh->GetBodySetup()->CreatePhysicsMeshes();
+        SetupCollision(StaticMesh);
     }
 
     const bool _ { StaticMesh->MarkPackageDirty() };
+}
+#endif
+
+TObjectPtr<UStaticMesh> FStaticMeshConstructor::CreateStaticMesh(UObject* Outer, const TCHAR* MeshName)
+{
+    TObjectPtr<UStaticMesh> StaticMesh {
+        NewObject<UStaticMesh>(
+            Outer,
+            MeshName,
+            RF_Public | RF_Standalone
+        )
+    };
+
+    if (StaticMesh->GetStaticMaterials().Num() == 0)
+    {
+        UMaterialInterface* DefaultMat { UMaterial::GetDefaultMaterial(MD_Surface) };
+        StaticMesh->AddMaterial(DefaultMat);
+    }
 
     return StaticMesh;
-}
\ No newline at end of file
+}
+
+void FStaticMeshConstructor::SetupCollision(UStaticMesh* StaticMesh)
+{
+    StaticMesh->bAllowCPUAccess = true;
+
+    StaticMesh->CreateBodySetup();
+    StaticMesh->GetBodySetup()->CollisionTraceFlag = CTF_UseComplexAsSimple;
+    StaticMesh->GetBodySetup()->bMeshCollideAll = true;
+    StaticMesh->GetBodySetup()->bHasCookedCollisionData = true;
+    StaticMesh->GetBodySetup()->CreatePhysicsMeshes();
+}
@@ -2,9 +2,11 @@
 
 #include "CoreMinimal.h"
 #include "../Data/MeshRenderData.h"
+#include "../Data/SectorMeshes.h"
 
 
 class UStaticMesh;
+struct FMeshDescription;
 struct FSectorRenderData;
 
 struct FStaticMeshConstructor
@@ -15,4 +17,30 @@ struct FStaticMeshConstructor
 		const FMeshRenderData& MeshRenderData,
 		const bool bGenerateCollision = false
 	);
-};
\ No newline at end of file
+
+#if WITH_EDITOR
+	static TObjectPtr<UStaticMesh> RunFromMeshDescription(
+		UObject* Outer,
+		const TCHAR* MeshName,
+		const FMeshRenderData& MeshRenderData,
+		const bool bGenerateCollision = false
+	);
+	
+	// Builds both meshes of every sector concurrently, calling back once per sector when its pair is done
+	static void RunBatchFromMeshDescription(
+		UObject* Outer,
+		const TConstArrayView<const FSectorRenderData*> SectorRenderDataArray,
+		TFunction<void(const FIntPoint SectorCoordinates, const FSectorMeshes& SectorMeshes)> OnSectorBuilt
+	);
+#endif
+
+private:
+	static TObjectPtr<UStaticMesh> CreateStaticMesh(UObject* Outer, const TCHAR* MeshName);
+	static void SetupCollision(UStaticMesh* StaticMesh);
+
+#if WITH_EDITOR
+	static void BuildMeshDescription(const FMeshRenderData& MeshRenderData, FMeshDescription& MeshDescription);
+	static void SetupSourceModel(UStaticMesh* StaticMesh, FMeshDescription&& MeshDescription);
+	static void FinishBuild(UStaticMesh* StaticMesh, const bool bGenerateCollision);
+#endif
+};
@@ -0,0 +1,214 @@
+#include "TerrainEroder.h"
+#include "Async/ParallelFor.h"
+
+
+int32 FTerrainEroder::GetHaloInCells(const FErosionSettings& ErosionSettings)
+{
+	// Each iteration reads neighbors in three passes, so its results reach three cells further than its inputs
+	return 3 * FMath::Max(0, ErosionSettings.IterationNum);
+}
+
+void FTerrainEroder::Run(
+	const FErosionSettings& ErosionSettings,
+	const float CellSizeInCentimeters,
+	FTerrainSampleRegion& Region,
+	TArray<float>& HeightArray
+) {
+	const FIntPoint VertexNum { Region.SizeInCells + FIntPoint { 1 } };
+	const int32 ArrayNum { VertexNum.X * VertexNum.Y };
+	
+	TArray<float>& NextHeightArray { Region.ErosionHeightArray };
+	NextHeightArray.SetNumUninitialized(ArrayNum);
+	
+	Region.WaterArray.SetNumZeroed(ArrayNum);
+	Region.NextWaterArray.SetNumUninitialized(ArrayNum);
+	Region.SedimentArray.SetNumZeroed(ArrayNum);
+	Region.NextSedimentArray.SetNumUninitialized(ArrayNum);
+	
+	for (TArray<float>& FluxArray : Region.FluxArrays)
+	{
+		FluxArray.SetNumZeroed(ArrayNum);
+	}
+	
+	// Outgoing flux toward the -X, +X, -Y and +Y neighbors
+	float* FluxL { Region.FluxArrays[0].GetData() };
+	float* FluxR { Region.FluxArrays[1].GetData() };
+	float* FluxU { Region.FluxArrays[2].GetData() };
+	float* FluxD { Region.FluxArrays[3].GetData() };
+	
+	for (int32 Iteration { 0 }; Iteration < ErosionSettings.IterationNum; ++Iteration)
+	{
+		const float* Height { HeightArray.GetData() };
+		const float* Water { Region.WaterArray.GetData() };
+		const float* Sediment { Region.SedimentArray.GetData() };
+		
+		float* NextHeight { NextHeightArray.GetData() };
+		float* NextWater { Region.NextWaterArray.GetData() };
+		float* NextSediment { Region.NextSedimentArray.GetData() };
+		
+		// Every pass only reads the previous pass's arrays, so tiles can run in any order on any thread
+		ForEachTile(
+			VertexNum,
+			[&](const int32 Y, const int32 XBegin, const int32 XEnd)
+			{
+				const int32 RowBase { Y * VertexNum.X };
+				const int32 RowU { Y > 0 ? RowBase - VertexNum.X : RowBase };
+				const int32 RowD { Y < VertexNum.Y - 1 ? RowBase + VertexNum.X : RowBase };
+				
+				for (int32 X { XBegin }; X < XEnd; ++X)
+				{
+					const int32 Index { RowBase + X };
+					
+					// Border vertices use themselves as the missing neighbor, which gives no flow across the border
+					const int32 IndexL { X > 0 ? Index - 1 : Index };
+					const int32 IndexR { X < VertexNum.X - 1 ? Index + 1 : Index };
+					const int32 IndexU { RowU + X };
+					const int32 IndexD { RowD + X };
+					
+					const float Level { Height[Index] + Water[Index] + ErosionSettings.RainAmount };
+					
+					const float L { FMath::Max(0.0f, FluxL[Index] + PipeFlowScale * (Level - Height[IndexL] - Water[IndexL] - ErosionSettings.RainAmount)) };
+					const float R { FMath::Max(0.0f, FluxR[Index] + PipeFlowScale * (Level - Height[IndexR] - Water[IndexR] - ErosionSettings.RainAmount)) };
+					const float U { FMath::Max(0.0f, FluxU[Index] + PipeFlowScale * (Level - Height[IndexU] - Water[IndexU] - ErosionSettings.RainAmount)) };
+					const float D { FMath::Max(0.0f, FluxD[Index] + PipeFlowScale * (Level - Height[IndexD] - Water[IndexD] - ErosionSettings.RainAmount)) };
+					
+					// Outflow is scaled down so a vertex never sends more water than it holds
+					const float Outflow { L + R + U + D };
+					const float Scale { Outflow > 0.0f ? FMath::Min(1.0f, (Water[Index] + ErosionSettings.RainAmount) / Outflow) : 0.0f };
+					
+					FluxL[Index] = X > 0 ? L * Scale : 0.0f;
+					FluxR[Index] = X < VertexNum.X - 1 ? R * Scale : 0.0f;
+					FluxU[Index] = Y > 0 ? U * Scale : 0.0f;
+					FluxD[Index] = Y < VertexNum.Y - 1 ? D * Scale : 0.0f;
+				}
+			}
+		);
+		
+		ForEachTile(
+			VertexNum,
+			[&](const int32 Y, const int32 XBegin, const int32 XEnd)
+			{
+				const int32 RowBase { Y * VertexNum.X };
+				const int32 RowU { Y > 0 ? RowBase - VertexNum.X : RowBase };
+				const int32 RowD { Y < VertexNum.Y - 1 ? RowBase + VertexNum.X : RowBase };
+				
+				for (int32 X { XBegin }; X < XEnd; ++X)
+				{
+					const int32 Index { RowBase + X };
+					const int32 IndexL { X > 0 ? Index - 1 : Index };
+					const int32 IndexR { X < VertexNum.X - 1 ? Index + 1 : Index };
+					const int32 IndexU { RowU + X };
+					const int32 IndexD { RowD + X };
+					
+					// Border neighbors are the vertex itself, whose flux toward the border is already zero
+					const float Inflow { 
+						(X > 0 ? FluxR[IndexL] : 0.0f) + 
+						(X < VertexNum.X - 1 ? FluxL[IndexR] : 0.0f) + 
+						(Y > 0 ? FluxD[IndexU] : 0.0f) + 
+						(Y < VertexNum.Y - 1 ? FluxU[IndexD] : 0.0f) 
+					};
+					
+					const float Outflow { FluxL[Index] + FluxR[Index] + FluxU[Index] + FluxD[Index] };
+					
+					const float FlowX { 0.5f * ((X > 0 ? FluxR[IndexL] : 0.0f) - FluxL[Index] + FluxR[Index] - (X < VertexNum.X - 1 ? FluxL[IndexR] : 0.0f)) };
+					const float FlowY { 0.5f * ((Y > 0 ? FluxD[IndexU] : 0.0f) - FluxU[Index] + FluxD[Index] - (Y < VertexNum.Y - 1 ? FluxU[IndexD] : 0.0f)) };
+					
+					const float SlopeX { (Height[IndexR] - Height[IndexL]) / ((IndexR - IndexL) * CellSizeInCentimeters + UE_SMALL_NUMBER) };
+					const float SlopeY { (Height[IndexD] - Height[IndexU]) / ((IndexD - IndexU) / VertexNum.X * CellSizeInCentimeters + UE_SMALL_NUMBER) };
+					
+					const float Slope { FMath::Max(MinSlope, FMath::Sqrt(SlopeX * SlopeX + SlopeY * SlopeY)) };
+					
+					const float Capacity { ErosionSettings.SedimentCapacity * Slope * FMath::Sqrt(FlowX * FlowX + FlowY * FlowY) };
+					
+					// Positive amounts take material from the ground into the water, negative amounts settle it
+					const float Exchange {
+						Capacity > Sediment[Index]
+							? FMath::Min(ErosionSettings.ErosionRate * (Capacity - Sediment[Index]), ErosionSettings.MaxErosionDepth)
+							: ErosionSettings.DepositionRate * (Capacity - Sediment[Index])
+					};
+					
+					NextHeight[Index] = Height[Index] - Exchange;
+					NextSediment[Index] = Sediment[Index] + Exchange;
+					NextWater[Index] = (Water[Index] + ErosionSettings.RainAmount + Inflow - Outflow) * (1.0f - ErosionSettings.EvaporationRate);
+				}
+			}
+		);
+		
+		// Suspended sediment moves with the water, in the same fractions that leave each vertex
+		ForEachTile(
+			VertexNum,
+			[&](const int32 Y, const int32 XBegin, const int32 XEnd)
+			{
+				const int32 RowBase { Y * VertexNum.X };
+				const int32 RowU { Y > 0 ? RowBase - VertexNum.X : RowBase };
+				const int32 RowD { Y < VertexNum.Y - 1 ? RowBase + VertexNum.X : RowBase };
+				
+				auto GetCarriedFraction = [&](const int32 Index, const float Flux)
+				{
+					return Flux / (Water[Index] + ErosionSettings.RainAmount + UE_SMALL_NUMBER);
+				};
+				
+				float* SedimentOut { Region.SedimentArray.GetData() };
+				
+				for (int32 X { XBegin }; X < XEnd; ++X)
+				{
+					const int32 Index { RowBase + X };
+					const int32 IndexL { X > 0 ? Index - 1 : Index };
+					const int32 IndexR { X < VertexNum.X - 1 ? Index + 1 : Index };
+					const int32 IndexU { RowU + X };
+					const int32 IndexD { RowD + X };
+					
+					const float Outflow { FluxL[Index] + FluxR[Index] + FluxU[Index] + FluxD[Index] };
+					
+					SedimentOut[Index] = 
+						NextSediment[Index] * (1.0f - FMath::Min(1.0f, GetCarriedFraction(Index, Outflow))) +
+						(X > 0 ? NextSediment[IndexL] * GetCarriedFraction(IndexL, FluxR[IndexL]) : 0.0f) +
+						(X < VertexNum.X - 1 ? NextSediment[IndexR] * GetCarriedFraction(IndexR, FluxL[IndexR]) : 0.0f) +
+						(Y > 0 ? NextSediment[IndexU] * GetCarriedFraction(IndexU, FluxD[IndexU]) : 0.0f) +
+						(Y < VertexNum.Y - 1 ? NextSediment[IndexD] * GetCarriedFraction(IndexD, FluxU[IndexD]) : 0.0f);
+				}
+			}
+		);
+		
+		Swap(HeightArray, NextHeightArray);
+		Swap(Region.WaterArray, Region.NextWaterArray);
+	}
+	
+	// Sediment still suspended when the water is dropped settles where it is
+	ForEachTile(
+		VertexNum,
+		[&](const int32 Y, const int32 XBegin, const int32 XEnd)
+		{
+			for (int32 Index { Y * VertexNum.X + XBegin }; Index < Y * VertexNum.X + XEnd; ++Index)
+			{
+				HeightArray[Index] += Region.SedimentArray[Index];
+			}
+		}
+	);
+}
+
+void FTerrainEroder::ForEachTile(
+	const FIntPoint VertexNum, 
+	const TFunctionRef<void(int32 Y, int32 XBegin, int32 XEnd)> SpanFunction
+) {
+	const FIntPoint TileNum { 
+		FMath::DivideAndRoundUp(VertexNum.X, TileSize), 
+		FMath::DivideAndRoundUp(VertexNum.Y, TileSize) 
+	};
+	
+	ParallelFor(
+		TEXT("TerrainErosion"),
+		TileNum.X * TileNum.Y,
+		1,
+		[&](const int32 TileIndex)
+		{
+			const FIntPoint TileMin { (TileIndex % TileNum.X) * TileSize, (TileIndex / TileNum.X) * TileSize };
+			const FIntPoint TileMax { (TileMin + FIntPoint { TileSize }).ComponentMin(VertexNum) };
+			
+			for (int32 Y { TileMin.Y }; Y < TileMax.Y; ++Y)
+			{
+				SpanFunction(Y, TileMin.X, TileMax.X);
+			}
+		}
+	);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../Data/ErosionSettings.h"
+#include "../Data/TerrainSampleRegion.h"
+
+
+struct FTerrainEroder
+{
+	// Cells around a region whose eroded heights depend on terrain outside it, and which are therefore not exact
+	static int32 GetHaloInCells(const FErosionSettings& ErosionSettings);
+	
+	// Grid-based hydraulic erosion of one height array of the region, using the region's erosion buffers
+	static void Run(
+		const FErosionSettings& ErosionSettings,
+		const float CellSizeInCentimeters,
+		FTerrainSampleRegion& Region,
+		TArray<float>& HeightArray
+	);
+
+private:
+	// Fraction of a height difference that starts flowing through a pipe per iteration, at most a quarter per direction
+	static constexpr float PipeFlowScale { 0.2f };
+	
+	// Slope used for flat ground so standing water still carries some sediment
+	static constexpr float MinSlope { 0.01f };
+	
+	// Square tiles keep a worker's neighbor reads within a few rows of one narrow column
+	static constexpr int32 TileSize { 32 };
+	
+	// Calls SpanFunction for each tile row span, with tiles spread across workers
+	static void ForEachTile(const FIntPoint VertexNum, const TFunctionRef<void(int32 Y, int32 XBegin, int32 XEnd)> SpanFunction);
+};
@@ -0,0 +1,354 @@
+#include "VoxelMesher.h"
+#include "Algo/AnyOf.h"
+#include "Async/ParallelFor.h"
+
+
+void FVoxelMesher::Run(
+	const FVoxelSettings& VoxelSettings,
+	const FastNoiseLite& DensityNoise,
+	const FastNoiseLite& MaskNoise,
+	const FTerrainSampleRegion& Region,
+	const FIntPoint SectorCoordinates,
+	const int32 SectorSizeInCells,
+	const float CellSizeInCentimeters,
+	const float BiomeIndexMax,
+	FSectorVoxelData& VoxelData
+) {
+	VoxelData.Clear();
+	
+	const FIntPoint SectorOriginInCells { SectorCoordinates * SectorSizeInCells };
+	const int32 ChunkSizeInCells { FMath::Max(1, VoxelSettings.ChunkSizeInCells) };
+	
+	SampleColumns(VoxelSettings, MaskNoise, Region, SectorOriginInCells, SectorSizeInCells, CellSizeInCentimeters, VoxelData);
+	
+	// A sector the mask leaves flat keeps its height-field mesh, at the cost of a sub-cell seam against volumetric neighbors
+	if (!Algo::AnyOf(VoxelData.ColumnAmplitudeArray, [](const float Amplitude) { return Amplitude > 0.0f; }))
+	{
+		return;
+	}
+	
+	GatherBricks(ChunkSizeInCells, SectorSizeInCells, CellSizeInCentimeters, VoxelData);
+	
+	TArrayView<FVoxelBrick> BrickArray { VoxelData.GetBricks() };
+	
+	ParallelFor(
+		BrickArray.Num(),
+		[&](const int32 BrickIndex)
+		{
+			ContourBrick(
+				DensityNoise, 
+				VoxelData, 
+				SectorOriginInCells, 
+				SectorSizeInCells, 
+				ChunkSizeInCells, 
+				CellSizeInCentimeters, 
+				BrickArray[BrickIndex]
+			);
+		},
+		BrickArray.Num() > 1 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread
+	);
+	
+	FMeshRenderData& MeshRenderData { VoxelData.MeshRenderData };
+	
+	int32 VertexNum { 0 };
+	int32 IndexNum { 0 };
+	
+	for (const FVoxelBrick& Brick : BrickArray)
+	{
+		VertexNum += Brick.VertexArray.Num();
+		IndexNum += Brick.IndexArray.Num();
+	}
+	
+	MeshRenderData.Reserve(VertexNum, IndexNum);
+	
+	const FIntPoint RegionOffset { SectorOriginInCells - Region.OriginInCells };
+	const float SectorSizeInCentimeters { SectorSizeInCells * CellSizeInCentimeters };
+	
+	// Bricks are appended in the order they were gathered, so the mesh does not depend on which worker contoured what
+	for (const FVoxelBrick& Brick : BrickArray)
+	{
+		const uint32 VertexBase { static_cast<uint32>(MeshRenderData.VertexArray.Num()) };
+		
+		for (const FVector3f& Vertex : Brick.VertexArray)
+		{
+			const FIntPoint CellCoordinates { 
+				FMath::Clamp(FMath::FloorToInt(Vertex.X / CellSizeInCentimeters), 0, SectorSizeInCells - 1),
+				FMath::Clamp(FMath::FloorToInt(Vertex.Y / CellSizeInCentimeters), 0, SectorSizeInCells - 1)
+			};
+			
+			const uint8 BiomeIndex { Region.CellBiomeIndexArray[Region.GetCellIndex(RegionOffset + CellCoordinates)] };
+			
+			MeshRenderData.VertexArray.Add(Vertex);
+			MeshRenderData.UVArray.Add(FVector2f { Vertex.X / SectorSizeInCentimeters, Vertex.Y / SectorSizeInCentimeters });
+			MeshRenderData.VertexColorArray.Add(
+				FVector4f { BiomeIndexMax > 0.0f ? static_cast<float>(BiomeIndex) / BiomeIndexMax : 0.0f, 0, 0, 1 }
+			);
+		}
+		
+		for (const uint32 Index : Brick.IndexArray)
+		{
+			MeshRenderData.IndexArray.Add(VertexBase + Index);
+		}
+	}
+	
+	VoxelData.bVolumetric = true;
+}
+
+void FVoxelMesher::SampleColumns(
+	const FVoxelSettings& VoxelSettings,
+	const FastNoiseLite& MaskNoise,
+	const FTerrainSampleRegion& Region,
+	const FIntPoint SectorOriginInCells,
+	const int32 SectorSizeInCells,
+	const float CellSizeInCentimeters,
+	FSectorVoxelData& VoxelData
+) {
+	// Columns run from one before the sector to its far edge, the points every cube touching the sector needs
+	const int32 ColumnNum { SectorSizeInCells + 2 };
+	const int32 VoxelRowNum { Region.VoxelSizeInCells.X + 1 };
+	
+	VoxelData.ColumnHeightArray.SetNumUninitialized(ColumnNum * ColumnNum);
+	VoxelData.ColumnAmplitudeArray.SetNumUninitialized(ColumnNum * ColumnNum);
+	
+	const float MaskRange { 1.0f - VoxelSettings.MaskThreshold };
+	
+	for (int32 Y { 0 }; Y < ColumnNum; ++Y)
+	{
+		for (int32 X { 0 }; X < ColumnNum; ++X)
+		{
+			const FIntPoint WorldCellCoordinates { SectorOriginInCells + FIntPoint { X - 1, Y - 1 } };
+			const FIntPoint VoxelCoordinates { WorldCellCoordinates - Region.VoxelOriginInCells };
+			
+			const int32 ColumnIndex { Y * ColumnNum + X };
+			
+			VoxelData.ColumnHeightArray[ColumnIndex] = Region.VoxelHeightArray[VoxelCoordinates.Y * VoxelRowNum + VoxelCoordinates.X];
+			
+			float Amplitude { 0.0f };
+			
+			if (MaskRange > 0.0f && VoxelSettings.DensityAmplitude > 0.0f)
+			{
+				const float Mask { 
+					MaskNoise.GetNoise(WorldCellCoordinates.X * CellSizeInCentimeters, WorldCellCoordinates.Y * CellSizeInCentimeters) 
+				};
+				
+				Amplitude = VoxelSettings.DensityAmplitude * FMath::Clamp((Mask - VoxelSettings.MaskThreshold) / MaskRange, 0.0f, 1.0f);
+			}
+			
+			VoxelData.ColumnAmplitudeArray[ColumnIndex] = Amplitude;
+		}
+	}
+}
+
+void FVoxelMesher::GatherBricks(
+	const int32 ChunkSizeInCells,
+	const int32 SectorSizeInCells,
+	const float CellSizeInCentimeters,
+	FSectorVoxelData& VoxelData
+) {
+	const int32 ColumnNum { SectorSizeInCells + 2 };
+	const int32 ChunkNum { FMath::DivideAndRoundUp(SectorSizeInCells, ChunkSizeInCells) };
+	const float ChunkHeight { ChunkSizeInCells * CellSizeInCentimeters };
+	
+	for (int32 ChunkY { 0 }; ChunkY < ChunkNum; ++ChunkY)
+	{
+		for (int32 ChunkX { 0 }; ChunkX < ChunkNum; ++ChunkX)
+		{
+			const FIntPoint ChunkOrigin { FIntPoint { ChunkX, ChunkY } * ChunkSizeInCells };
+			const FIntPoint ChunkSize { (FIntPoint { SectorSizeInCells } - ChunkOrigin).ComponentMin(FIntPoint { ChunkSizeInCells }) };
+			
+			// The density stays within the amplitude of the height field, which bounds where the surface can be
+			float MinSurfaceHeight { TNumericLimits<float>::Max() };
+			float MaxSurfaceHeight { TNumericLimits<float>::Lowest() };
+			
+			for (int32 Y { ChunkOrigin.Y }; Y <= ChunkOrigin.Y + ChunkSize.Y + 1; ++Y)
+			{
+				for (int32 X { ChunkOrigin.X }; X <= ChunkOrigin.X + ChunkSize.X + 1; ++X)
+				{
+					const float Height { VoxelData.ColumnHeightArray[Y * ColumnNum + X] };
+					const float Amplitude { VoxelData.ColumnAmplitudeArray[Y * ColumnNum + X] };
+					
+					MinSurfaceHeight = FMath::Min(MinSurfaceHeight, Height - Amplitude);
+					MaxSurfaceHeight = FMath::Max(MaxSurfaceHeight, Height + Amplitude);
+				}
+			}
+			
+			const int32 MinChunkZ { FMath::FloorToInt(MinSurfaceHeight / ChunkHeight) - 1 };
+			const int32 MaxChunkZ { FMath::FloorToInt(MaxSurfaceHeight / ChunkHeight) + 1 };
+			
+			for (int32 ChunkZ { MinChunkZ }; ChunkZ <= MaxChunkZ; ++ChunkZ)
+			{
+				const float MinPointHeight { (ChunkZ * ChunkSizeInCells - 1) * CellSizeInCentimeters };
+				const float MaxPointHeight { (ChunkZ + 1) * ChunkHeight };
+				
+				// Every point of a chunk below the surface bound is solid and every point above it is empty
+				if (MaxPointHeight < MinSurfaceHeight || MinPointHeight >= MaxSurfaceHeight)
+				{
+					continue;
+				}
+				
+				VoxelData.AddBrick(FIntVector { ChunkX, ChunkY, ChunkZ }, FIntVector { ChunkSize.X, ChunkSize.Y, ChunkSizeInCells });
+			}
+		}
+	}
+}
+
+void FVoxelMesher::ContourBrick(
+	const FastNoiseLite& DensityNoise,
+	const FSectorVoxelData& VoxelData,
+	const FIntPoint SectorOriginInCells,
+	const int32 SectorSizeInCells,
+	const int32 ChunkSizeInCells,
+	const float CellSizeInCentimeters,
+	FVoxelBrick& Brick
+) {
+	// Corners of a cube by bit: X in bit 0, Y in bit 1, Z in bit 2
+	static constexpr int32 CubeEdgeArray[12][2] {
+		{ 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 },
+		{ 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+		{ 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 }
+	};
+	
+	const int32 ColumnNum { SectorSizeInCells + 2 };
+	
+	const FIntVector Size { Brick.SizeInCells };
+	const FIntVector PointNum { Brick.GetPointNum() };
+	const FIntVector Origin { Brick.ChunkCoordinates * ChunkSizeInCells };
+	
+	TArray<float>& DensityArray { Brick.DensityArray };
+	DensityArray.SetNumUninitialized(PointNum.X * PointNum.Y * PointNum.Z);
+	
+	// Positive density is solid; columns without amplitude reduce to the height field and skip the 3D noise
+	for (int32 Z { -1 }; Z <= Size.Z; ++Z)
+	{
+		const float Height { (Origin.Z + Z) * CellSizeInCentimeters };
+		
+		for (int32 Y { -1 }; Y <= Size.Y; ++Y)
+		{
+			for (int32 X { -1 }; X <= Size.X; ++X)
+			{
+				const int32 ColumnIndex { (Origin.Y + Y + 1) * ColumnNum + Origin.X + X + 1 };
+				
+				float Density { VoxelData.ColumnHeightArray[ColumnIndex] - Height };
+				
+				if (const float Amplitude { VoxelData.ColumnAmplitudeArray[ColumnIndex] }; Amplitude > 0.0f)
+				{
+					Density += Amplitude * DensityNoise.GetNoise(
+						(SectorOriginInCells.X + Origin.X + X) * CellSizeInCentimeters, 
+						(SectorOriginInCells.Y + Origin.Y + Y) * CellSizeInCentimeters, 
+						Height
+					);
+				}
+				
+				DensityArray[Brick.GetPointIndex(X, Y, Z)] = Density;
+			}
+		}
+	}
+	
+	Brick.CubeVertexArray.Init(INDEX_NONE, (Size.X + 1) * (Size.Y + 1) * (Size.Z + 1));
+	Brick.VertexArray.Reset();
+	Brick.IndexArray.Reset();
+	
+	// Each cube the surface crosses gets one vertex at the mean of its edge crossings
+	for (int32 Z { -1 }; Z < Size.Z; ++Z)
+	{
+		for (int32 Y { -1 }; Y < Size.Y; ++Y)
+		{
+			for (int32 X { -1 }; X < Size.X; ++X)
+			{
+				float CornerDensityArray[8];
+				uint32 SolidMask { 0 };
+				
+				for (int32 Corner { 0 }; Corner < 8; ++Corner)
+				{
+					CornerDensityArray[Corner] = DensityArray[Brick.GetPointIndex(X + (Corner & 1), Y + (Corner >> 1 & 1), Z + (Corner >> 2 & 1))];
+					
+					SolidMask |= (CornerDensityArray[Corner] > 0.0f ? 1u : 0u) << Corner;
+				}
+				
+				if (SolidMask == 0 || SolidMask == 0xFF)
+				{
+					continue;
+				}
+				
+				FVector3f CrossingSum { FVector3f::ZeroVector };
+				int32 CrossingNum { 0 };
+				
+				for (const auto& [Corner0, Corner1] : CubeEdgeArray)
+				{
+					if ((SolidMask >> Corner0 & 1) == (SolidMask >> Corner1 & 1))
+					{
+						continue;
+					}
+					
+					const float Alpha { CornerDensityArray[Corner0] / (CornerDensityArray[Corner0] - CornerDensityArray[Corner1]) };
+					
+					const FVector3f Position0 { static_cast<float>(Corner0 & 1), static_cast<float>(Corner0 >> 1 & 1), static_cast<float>(Corner0 >> 2 & 1) };
+					const FVector3f Position1 { static_cast<float>(Corner1 & 1), static_cast<float>(Corner1 >> 1 & 1), static_cast<float>(Corner1 >> 2 & 1) };
+					
+					CrossingSum += FMath::Lerp(Position0, Position1, Alpha);
+					++CrossingNum;
+				}
+				
+				const FVector3f CubePosition { 
+					FVector3f { static_cast<float>(Origin.X + X), static_cast<float>(Origin.Y + Y), static_cast<float>(Origin.Z + Z) } + 
+					CrossingSum / CrossingNum 
+				};
+				
+				Brick.CubeVertexArray[Brick.GetCubeIndex(X, Y, Z)] = Brick.VertexArray.Add(CubePosition * CellSizeInCentimeters);
+			}
+		}
+	}
+	
+	// A brick owns the edges starting inside it, so every edge of the sector is emitted by exactly one brick
+	for (int32 Z { 0 }; Z < Size.Z; ++Z)
+	{
+		for (int32 Y { 0 }; Y < Size.Y; ++Y)
+		{
+			for (int32 X { 0 }; X < Size.X; ++X)
+			{
+				const FIntVector Point { X, Y, Z };
+				const bool bSolid { DensityArray[Brick.GetPointIndex(X, Y, Z)] > 0.0f };
+				
+				for (int32 Axis { 0 }; Axis < 3; ++Axis)
+				{
+					FIntVector AxisOffset { FIntVector::ZeroValue };
+					AxisOffset[Axis] = 1;
+					
+					const FIntVector NextPoint { Point + AxisOffset };
+					
+					if (bSolid == (DensityArray[Brick.GetPointIndex(NextPoint.X, NextPoint.Y, NextPoint.Z)] > 0.0f))
+					{
+						continue;
+					}
+					
+					FIntVector OffsetB { FIntVector::ZeroValue };
+					OffsetB[(Axis + 1) % 3] = 1;
+					
+					FIntVector OffsetC { FIntVector::ZeroValue };
+					OffsetC[(Axis + 2) % 3] = 1;
+					
+					auto GetCubeVertex = [&](const FIntVector Cube)
+					{
+						return static_cast<uint32>(Brick.CubeVertexArray[Brick.GetCubeIndex(Cube.X, Cube.Y, Cube.Z)]);
+					};
+					
+					// The four cubes around the edge in winding order about the axis
+					const uint32 Vertex0 { GetCubeVertex(Point - OffsetB - OffsetC) };
+					const uint32 Vertex1 { GetCubeVertex(Point - OffsetC) };
+					const uint32 Vertex2 { GetCubeVertex(Point) };
+					const uint32 Vertex3 { GetCubeVertex(Point - OffsetB) };
+					
+					// Faces point from solid to empty, matching the winding of the height field mesh
+					if (bSolid)
+					{
+						Brick.IndexArray.Append({ Vertex0, Vertex2, Vertex1, Vertex0, Vertex3, Vertex2 });
+					}
+					else
+					{
+						Brick.IndexArray.Append({ Vertex0, Vertex1, Vertex2, Vertex0, Vertex2, Vertex3 });
+					}
+				}
+			}
+		}
+	}
+}
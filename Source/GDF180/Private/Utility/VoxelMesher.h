@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../../ThirdParty/FastNoiseLite/FastNoiseLite.h"
+#include "../Data/SectorVoxelData.h"
+#include "../Data/TerrainSampleRegion.h"
+#include "../Data/VoxelSettings.h"
+
+
+struct FVoxelMesher
+{
+	// Stores the bricks of the sector's chunks that straddle the surface and contours them into the ground mesh
+	static void Run(
+		const FVoxelSettings& VoxelSettings,
+		const FastNoiseLite& DensityNoise,
+		const FastNoiseLite& MaskNoise,
+		const FTerrainSampleRegion& Region,
+		const FIntPoint SectorCoordinates,
+		const int32 SectorSizeInCells,
+		const float CellSizeInCentimeters,
+		const float BiomeIndexMax,
+		FSectorVoxelData& VoxelData
+	);
+
+private:
+	static void SampleColumns(
+		const FVoxelSettings& VoxelSettings,
+		const FastNoiseLite& MaskNoise,
+		const FTerrainSampleRegion& Region,
+		const FIntPoint SectorOriginInCells,
+		const int32 SectorSizeInCells,
+		const float CellSizeInCentimeters,
+		FSectorVoxelData& VoxelData
+	);
+	
+	static void GatherBricks(
+		const int32 ChunkSizeInCells,
+		const int32 SectorSizeInCells,
+		const float CellSizeInCentimeters,
+		FSectorVoxelData& VoxelData
+	);
+	
+	static void ContourBrick(
+		const FastNoiseLite& DensityNoise,
+		const FSectorVoxelData& VoxelData,
+		const FIntPoint SectorOriginInCells,
+		const int32 SectorSizeInCells,
+		const int32 ChunkSizeInCells,
+		const float CellSizeInCentimeters,
+		FVoxelBrick& Brick
+	);
+};
@@ -52,6 +52,13 @@
 
 #include <cmath>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FNL_SSE2 1
+#include <emmintrin.h>
+#else
+#define FNL_SSE2 0
+#endif
+
 class FastNoiseLite
 {
 public:
@@ -108,6 +115,40 @@ public:
         DomainWarpType_BasicGrid
     };
 
+    /// <summary>
+    /// Winning cell of a 2D cellular query
+    /// </summary>
+    /// <remarks>
+    /// x, y: integer lattice coordinates of the closest cell
+    /// hash: cell hash, value: CellValue return for the same cell
+    /// distance: distance to the cell point using the current distance function
+    /// </remarks>
+    struct CellularCell
+    {
+        int x;
+        int y;
+        int hash;
+        float value;
+        float distance;
+        int candidate; // Index of the winning candidate for candidate-list queries, otherwise -1
+    };
+
+    /// <summary>
+    /// Cell that may win a 2D cellular query inside a bounded area
+    /// </summary>
+    /// <remarks>
+    /// x, y: integer lattice coordinates, hash: cell hash
+    /// jitterX, jitterY: offset of the cell point from its lattice position
+    /// </remarks>
+    struct CellularCandidate
+    {
+        int x;
+        int y;
+        int hash;
+        float jitterX;
+        float jitterY;
+    };
+
     /// <summary>
     /// Create new FastNoise object with optional seed
     /// </summary>
@@ -339,6 +380,173 @@ public:
     }
 
 
+    /// <summary>
+    /// 2D cellular query returning the winning cell in a single evaluation
+    /// </summary>
+    /// <remarks>
+    /// Uses the current frequency, seed, jitter and distance function.
+    /// Fractal settings are ignored.
+    /// </remarks>
+    template <typename FNfloat>
+    CellularCell GetCellularCell(FNfloat x, FNfloat y) const
+    {
+        Arguments_must_be_floating_point_values<FNfloat>();
+
+        x *= mFrequency;
+        y *= mFrequency;
+
+        return SingleCellularCell(mSeed, x, y);
+    }
+
+
+    /// <summary>
+    /// Batched 2D cellular query, evaluated 4 points at a time when SSE2 is available
+    /// </summary>
+    /// <remarks>
+    /// Results match GetCellularCell(x[i], y[i]) exactly.
+    /// </remarks>
+    void GetCellularCells(const float* x, const float* y, CellularCell* cells, int count) const
+    {
+        int i = 0;
+#if FNL_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            SingleCellularCell4(mSeed, x + i, y + i, cells + i, nullptr, 0);
+        }
+#endif
+        for (; i < count; i++)
+        {
+            cells[i] = GetCellularCell(x[i], y[i]);
+        }
+    }
+
+    /// <summary>
+    /// Batched 2D cellular query resolved against a precomputed candidate list
+    /// </summary>
+    /// <remarks>
+    /// Results match GetCellularCell(x[i], y[i], candidates, candidateCount) exactly.
+    /// </remarks>
+    void GetCellularCells(const float* x, const float* y, CellularCell* cells, int count, const CellularCandidate* candidates, int candidateCount) const
+    {
+        int i = 0;
+#if FNL_SSE2
+        for (; i + 4 <= count; i += 4)
+        {
+            SingleCellularCell4(mSeed, x + i, y + i, cells + i, candidates, candidateCount);
+        }
+#endif
+        for (; i < count; i++)
+        {
+            cells[i] = GetCellularCell(x[i], y[i], candidates, candidateCount);
+        }
+    }
+
+    /// <summary>
+    /// Lattice range of the cells that can win a 2D cellular query inside the given bounds
+    /// </summary>
+    template <typename FNfloat>
+    void GetCellularCandidateRange(FNfloat minX, FNfloat minY, FNfloat maxX, FNfloat maxY, int& cellMinX, int& cellMinY, int& cellMaxX, int& cellMaxY) const
+    {
+        Arguments_must_be_floating_point_values<FNfloat>();
+
+        cellMinX = FastRound(minX * mFrequency) - 1;
+        cellMinY = FastRound(minY * mFrequency) - 1;
+        cellMaxX = FastRound(maxX * mFrequency) + 1;
+        cellMaxY = FastRound(maxY * mFrequency) + 1;
+    }
+
+    /// <summary>
+    /// Candidate data for a single 2D cell
+    /// </summary>
+    CellularCandidate GetCellularCandidate(int cellX, int cellY) const
+    {
+        float cellularJitter = 0.43701595f * mCellularJitterModifier;
+
+        int hash = Hash(mSeed, cellX * PrimeX, cellY * PrimeY);
+        int idx = hash & (255 << 1);
+
+        return { cellX, cellY, hash, Lookup<float>::RandVecs2D[idx] * cellularJitter, Lookup<float>::RandVecs2D[idx | 1] * cellularJitter };
+    }
+
+    /// <summary>
+    /// 2D cellular query resolved against a precomputed candidate list
+    /// </summary>
+    /// <remarks>
+    /// Candidates must come from GetCellularCandidate over a range returned by
+    /// GetCellularCandidateRange for bounds containing (x, y), ordered by x then y.
+    /// That range covers the 3x3 cells around (FastRound(x), FastRound(y)); only
+    /// those candidates are tested, in the same order and with the same arithmetic
+    /// as SingleCellularCell, so the result is identical to GetCellularCell(x, y).
+    /// </remarks>
+    template <typename FNfloat>
+    CellularCell GetCellularCell(FNfloat x, FNfloat y, const CellularCandidate* candidates, int candidateCount) const
+    {
+        Arguments_must_be_floating_point_values<FNfloat>();
+
+        x *= mFrequency;
+        y *= mFrequency;
+
+        int xr = FastRound(x);
+        int yr = FastRound(y);
+
+        CellularCell cell = { xr, yr, 0, 0, 1e10f, -1 };
+
+        for (int i = 0; i < candidateCount; i++)
+        {
+            const CellularCandidate& candidate = candidates[i];
+
+            if (candidate.x < xr - 1 || candidate.x > xr + 1 || candidate.y < yr - 1 || candidate.y > yr + 1)
+            {
+                continue;
+            }
+
+            float vecX = (float)(candidate.x - x) + candidate.jitterX;
+            float vecY = (float)(candidate.y - y) + candidate.jitterY;
+
+            float newDistance = CellularDistance(vecX, vecY);
+
+            if (newDistance < cell.distance)
+            {
+                cell.x = candidate.x;
+                cell.y = candidate.y;
+                cell.hash = candidate.hash;
+                cell.distance = newDistance;
+                cell.candidate = i;
+            }
+        }
+
+        if (mCellularDistanceFunction == CellularDistanceFunction_Euclidean)
+        {
+            cell.distance = FastSqrt(cell.distance);
+        }
+
+        cell.value = cell.hash * (1 / 2147483648.0f);
+
+        return cell;
+    }
+
+    /// <summary>
+    /// Position of a 2D cell's jittered point, in input coordinates
+    /// </summary>
+    /// <remarks>
+    /// Canonical point of the cell returned by GetCellularCell. Depends only on
+    /// the seed, frequency, jitter and the cell's lattice coordinates.
+    /// </remarks>
+    template <typename FNfloat>
+    void GetCellularPoint(int cellX, int cellY, FNfloat& x, FNfloat& y) const
+    {
+        Arguments_must_be_floating_point_values<FNfloat>();
+
+        float cellularJitter = 0.43701595f * mCellularJitterModifier;
+
+        int hash = Hash(mSeed, cellX * PrimeX, cellY * PrimeY);
+        int idx = hash & (255 << 1);
+
+        x = ((FNfloat)cellX + Lookup<float>::RandVecs2D[idx] * cellularJitter) / mFrequency;
+        y = ((FNfloat)cellY + Lookup<float>::RandVecs2D[idx | 1] * cellularJitter) / mFrequency;
+    }
+
+
     /// <summary>
     /// 2D warps the input position using current domain warp settings
     /// </summary>
@@ -1609,6 +1817,242 @@ private:
         }
     }
 
+#if FNL_SSE2
+    static __m128i MulLo4(__m128i a, __m128i b)
+    {
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    static __m128i FastRound4(__m128 f)
+    {
+        __m128 positive = _mm_cmpge_ps(f, _mm_setzero_ps());
+        __m128 offset = _mm_or_ps(_mm_and_ps(positive, _mm_set1_ps(0.5f)), _mm_andnot_ps(positive, _mm_set1_ps(-0.5f)));
+
+        return _mm_cvttps_epi32(_mm_add_ps(f, offset));
+    }
+
+    static __m128 Select4(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    static __m128i Select4(__m128i mask, __m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    __m128 CellularDistance4(__m128 vecX, __m128 vecY) const
+    {
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+        switch (mCellularDistanceFunction)
+        {
+        default:
+        case CellularDistanceFunction_Euclidean:
+        case CellularDistanceFunction_EuclideanSq:
+            return _mm_add_ps(_mm_mul_ps(vecX, vecX), _mm_mul_ps(vecY, vecY));
+        case CellularDistanceFunction_Manhattan:
+            return _mm_add_ps(_mm_and_ps(vecX, absMask), _mm_and_ps(vecY, absMask));
+        case CellularDistanceFunction_Hybrid:
+            return _mm_add_ps(
+                _mm_add_ps(_mm_and_ps(vecX, absMask), _mm_and_ps(vecY, absMask)),
+                _mm_add_ps(_mm_mul_ps(vecX, vecX), _mm_mul_ps(vecY, vecY)));
+        }
+    }
+
+    // 4-wide SingleCellularCell, or the candidate-list query when candidates is not null
+    void SingleCellularCell4(int seed, const float* px, const float* py, CellularCell* cells, const CellularCandidate* candidates, int candidateCount) const
+    {
+        const __m128 frequency = _mm_set1_ps(mFrequency);
+
+        __m128 x = _mm_mul_ps(_mm_loadu_ps(px), frequency);
+        __m128 y = _mm_mul_ps(_mm_loadu_ps(py), frequency);
+
+        __m128i xr = FastRound4(x);
+        __m128i yr = FastRound4(y);
+
+        __m128 distance = _mm_set1_ps(1e10f);
+        __m128i closestX = xr;
+        __m128i closestY = yr;
+        __m128i closestHash = _mm_setzero_si128();
+        __m128i closestCandidate = _mm_set1_epi32(-1);
+
+        if (candidates)
+        {
+            const __m128i lowerBound = _mm_set1_epi32(-2);
+            const __m128i upperBound = _mm_set1_epi32(2);
+
+            for (int i = 0; i < candidateCount; i++)
+            {
+                const CellularCandidate& candidate = candidates[i];
+
+                // Lanes only accept candidates in their own 3x3 neighborhood, matching the scalar query
+                __m128i offsetX = _mm_sub_epi32(_mm_set1_epi32(candidate.x), xr);
+                __m128i offsetY = _mm_sub_epi32(_mm_set1_epi32(candidate.y), yr);
+                __m128i inRange = _mm_and_si128(
+                    _mm_and_si128(_mm_cmpgt_epi32(offsetX, lowerBound), _mm_cmplt_epi32(offsetX, upperBound)),
+                    _mm_and_si128(_mm_cmpgt_epi32(offsetY, lowerBound), _mm_cmplt_epi32(offsetY, upperBound)));
+
+                __m128 vecX = _mm_add_ps(_mm_sub_ps(_mm_set1_ps((float)candidate.x), x), _mm_set1_ps(candidate.jitterX));
+                __m128 vecY = _mm_add_ps(_mm_sub_ps(_mm_set1_ps((float)candidate.y), y), _mm_set1_ps(candidate.jitterY));
+
+                __m128 newDistance = CellularDistance4(vecX, vecY);
+                __m128 closer = _mm_and_ps(_mm_cmplt_ps(newDistance, distance), _mm_castsi128_ps(inRange));
+                __m128i closerInt = _mm_castps_si128(closer);
+
+                distance = Select4(closer, newDistance, distance);
+                closestX = Select4(closerInt, _mm_set1_epi32(candidate.x), closestX);
+                closestY = Select4(closerInt, _mm_set1_epi32(candidate.y), closestY);
+                closestHash = Select4(closerInt, _mm_set1_epi32(candidate.hash), closestHash);
+                closestCandidate = Select4(closerInt, _mm_set1_epi32(i), closestCandidate);
+            }
+        }
+        else
+        {
+            const __m128 cellularJitter = _mm_set1_ps(0.43701595f * mCellularJitterModifier);
+            const __m128i seed4 = _mm_set1_epi32(seed);
+            const __m128i one = _mm_set1_epi32(1);
+
+            __m128i xPrimed = MulLo4(_mm_sub_epi32(xr, one), _mm_set1_epi32(PrimeX));
+            __m128i yPrimedBase = MulLo4(_mm_sub_epi32(yr, one), _mm_set1_epi32(PrimeY));
+
+            alignas(16) int idx[4];
+
+            for (int xo = -1; xo <= 1; xo++)
+            {
+                __m128i xi = _mm_add_epi32(xr, _mm_set1_epi32(xo));
+                __m128 xd = _mm_sub_ps(_mm_cvtepi32_ps(xi), x);
+
+                __m128i yPrimed = yPrimedBase;
+
+                for (int yo = -1; yo <= 1; yo++)
+                {
+                    __m128i yi = _mm_add_epi32(yr, _mm_set1_epi32(yo));
+                    __m128 yd = _mm_sub_ps(_mm_cvtepi32_ps(yi), y);
+
+                    __m128i hash = MulLo4(_mm_xor_si128(_mm_xor_si128(seed4, xPrimed), yPrimed), _mm_set1_epi32(0x27d4eb2d));
+                    _mm_store_si128((__m128i*)idx, _mm_and_si128(hash, _mm_set1_epi32(255 << 1)));
+
+                    __m128 randX = _mm_setr_ps(
+                        Lookup<float>::RandVecs2D[idx[0]], Lookup<float>::RandVecs2D[idx[1]],
+                        Lookup<float>::RandVecs2D[idx[2]], Lookup<float>::RandVecs2D[idx[3]]);
+                    __m128 randY = _mm_setr_ps(
+                        Lookup<float>::RandVecs2D[idx[0] | 1], Lookup<float>::RandVecs2D[idx[1] | 1],
+                        Lookup<float>::RandVecs2D[idx[2] | 1], Lookup<float>::RandVecs2D[idx[3] | 1]);
+
+                    __m128 vecX = _mm_add_ps(xd, _mm_mul_ps(randX, cellularJitter));
+                    __m128 vecY = _mm_add_ps(yd, _mm_mul_ps(randY, cellularJitter));
+
+                    __m128 newDistance = CellularDistance4(vecX, vecY);
+                    __m128 closer = _mm_cmplt_ps(newDistance, distance);
+                    __m128i closerInt = _mm_castps_si128(closer);
+
+                    distance = Select4(closer, newDistance, distance);
+                    closestX = Select4(closerInt, xi, closestX);
+                    closestY = Select4(closerInt, yi, closestY);
+                    closestHash = Select4(closerInt, hash, closestHash);
+
+                    yPrimed = _mm_add_epi32(yPrimed, _mm_set1_epi32(PrimeY));
+                }
+                xPrimed = _mm_add_epi32(xPrimed, _mm_set1_epi32(PrimeX));
+            }
+        }
+
+        if (mCellularDistanceFunction == CellularDistanceFunction_Euclidean)
+        {
+            distance = _mm_sqrt_ps(distance);
+        }
+
+        __m128 value = _mm_mul_ps(_mm_cvtepi32_ps(closestHash), _mm_set1_ps(1 / 2147483648.0f));
+
+        alignas(16) int outX[4];
+        alignas(16) int outY[4];
+        alignas(16) int outHash[4];
+        alignas(16) float outValue[4];
+        alignas(16) float outDistance[4];
+        alignas(16) int outCandidate[4];
+
+        _mm_store_si128((__m128i*)outX, closestX);
+        _mm_store_si128((__m128i*)outY, closestY);
+        _mm_store_si128((__m128i*)outHash, closestHash);
+        _mm_store_ps(outValue, value);
+        _mm_store_ps(outDistance, distance);
+        _mm_store_si128((__m128i*)outCandidate, closestCandidate);
+
+        for (int i = 0; i < 4; i++)
+        {
+            cells[i] = { outX[i], outY[i], outHash[i], outValue[i], outDistance[i], outCandidate[i] };
+        }
+    }
+#endif
+
+    float CellularDistance(float vecX, float vecY) const
+    {
+        switch (mCellularDistanceFunction)
+        {
+        default:
+        case CellularDistanceFunction_Euclidean:
+        case CellularDistanceFunction_EuclideanSq:
+            return vecX * vecX + vecY * vecY;
+        case CellularDistanceFunction_Manhattan:
+            return FastAbs(vecX) + FastAbs(vecY);
+        case CellularDistanceFunction_Hybrid:
+            return (FastAbs(vecX) + FastAbs(vecY)) + (vecX * vecX + vecY * vecY);
+        }
+    }
+
+    template <typename FNfloat>
+    CellularCell SingleCellularCell(int seed, FNfloat x, FNfloat y) const
+    {
+        int xr = FastRound(x);
+        int yr = FastRound(y);
+
+        CellularCell cell = { xr, yr, 0, 0, 1e10f, -1 };
+
+        float cellularJitter = 0.43701595f * mCellularJitterModifier;
+
+        int xPrimed = (xr - 1) * PrimeX;
+        int yPrimedBase = (yr - 1) * PrimeY;
+
+        for (int xi = xr - 1; xi <= xr + 1; xi++)
+        {
+            int yPrimed = yPrimedBase;
+
+            for (int yi = yr - 1; yi <= yr + 1; yi++)
+            {
+                int hash = Hash(seed, xPrimed, yPrimed);
+                int idx = hash & (255 << 1);
+
+                float vecX = (float)(xi - x) + Lookup<float>::RandVecs2D[idx] * cellularJitter;
+                float vecY = (float)(yi - y) + Lookup<float>::RandVecs2D[idx | 1] * cellularJitter;
+
+                float newDistance = CellularDistance(vecX, vecY);
+
+                if (newDistance < cell.distance)
+                {
+                    cell.x = xi;
+                    cell.y = yi;
+                    cell.hash = hash;
+                    cell.distance = newDistance;
+                }
+                yPrimed += PrimeY;
+            }
+            xPrimed += PrimeX;
+        }
+
+        if (mCellularDistanceFunction == CellularDistanceFunction_Euclidean)
+        {
+            cell.distance = FastSqrt(cell.distance);
+        }
+
+        cell.value = cell.hash * (1 / 2147483648.0f);
+
+        return cell;
+    }
+
     template <typename FNfloat>
     float SingleCellular(int seed, FNfloat x, FNfloat y, FNfloat z) const
     {